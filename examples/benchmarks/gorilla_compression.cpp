@@ -0,0 +1,79 @@
+#include "../../include/cppyplot.hpp"
+
+#include <cmath>
+#include <random>
+
+/*
+  Compares gorilla encoding (Cppyplot::_gorilla) against the raw zero-copy buffer on sensor like data,
+  1kHz samples with timestamp jitter, 16bit ADC readings scaled to float/double
+*/
+
+template<typename Func>
+double time_ms(Func&& func, int n_runs)
+{
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < n_runs; i++)
+  { func(); }
+  auto stop = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count()/n_runs;
+}
+
+template<typename T>
+void report(const std::string& name, const T& data, int n_runs)
+{
+  using Cppyplot::fill_zmq_buffer;
+  zmq::message_t raw_buffer, encoded_buffer;
+
+  double raw_ms     = time_ms([&](){ fill_zmq_buffer(data, raw_buffer); }, n_runs);
+  auto   encoded    = Cppyplot::gorilla_encoded<T>{data};
+  double encoded_ms = time_ms([&](){ fill_zmq_buffer(encoded, encoded_buffer); }, n_runs);
+
+  double raw_mb = static_cast<double>(raw_buffer.size())/(1024.0*1024.0);
+  std::cout << name << ": raw " << raw_buffer.size() << " B (" << raw_ms << " ms)"
+            << ", gorilla " << encoded_buffer.size() << " B (" << encoded_ms << " ms, "
+            << raw_mb/(encoded_ms*1e-3) << " MB/s)"
+            << ", ratio " << static_cast<double>(raw_buffer.size())/static_cast<double>(encoded_buffer.size()) << '\n';
+}
+
+int main()
+{
+  constexpr std::size_t n_samples = 1'000'000u;
+  std::mt19937 gen(42);
+  std::normal_distribution<double> jitter(0.0, 20'000.0);
+  std::normal_distribution<double> noise(0.0, 2.0);
+
+  std::vector<std::chrono::system_clock::time_point> timestamps(n_samples);
+  std::vector<std::int64_t> timestamps_ns(n_samples);
+  std::vector<double> temperature(n_samples);
+  std::vector<float>  accel(n_samples);
+
+  const std::int64_t start_ns = 1'600'000'000'000'000'000;
+  for (std::size_t i = 0u; i < n_samples; i++)
+  {
+    timestamps_ns[i] = start_ns + static_cast<std::int64_t>(i)*1'000'000 + static_cast<std::int64_t>(jitter(gen));
+    timestamps[i]    = std::chrono::system_clock::time_point(std::chrono::nanoseconds(timestamps_ns[i]));
+    
+    // slowly varying temperature sampled by a 16bit ADC
+    auto temp_counts = std::round(20000.0 + 500.0*std::sin(static_cast<double>(i)*1e-4) + noise(gen));
+    temperature[i]   = temp_counts*0.0025;
+
+    auto accel_counts = std::round(1000.0*std::sin(static_cast<double>(i)*1e-2) + noise(gen));
+    accel[i]          = static_cast<float>(accel_counts)/4096.0F;
+  }
+
+  report("timestamps (time_point)", timestamps,    20);
+  report("timestamps (int64 ns)  ", timestamps_ns, 20);
+  report("temperature (double)   ", temperature,   20);
+  report("acceleration (float)   ", accel,         20);
+
+  Cppyplot::cppyplot pyp;
+  pyp.raw(R"pyp(
+  plt.figure(figsize=(8,5))
+  plt.plot(timestamps[::100], temperature[::100], 'r-', linewidth=1)
+  plt.grid(True)
+  plt.ylabel("temperature (deg C)", fontsize=12)
+  plt.show()
+  )pyp", Cppyplot::_gorilla(_p(timestamps)), Cppyplot::_gorilla(_p(temperature)));
+
+  return EXIT_SUCCESS;
+}
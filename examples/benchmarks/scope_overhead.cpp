@@ -0,0 +1,74 @@
+#include "../../include/cppyplot.hpp"
+
+/*
+  Per scope cost of CPPYPLOT_SCOPE: disabled, recorded (buffer drained between rounds, outside of the timing)
+  and recorded with four nested scopes, against an empty loop and a bare clock read (TSC on x86-64)
+*/
+
+constexpr std::size_t scopes_per_round = 10'000u;   // fits into one thread buffer
+constexpr int         n_rounds         = 200;
+
+template<typename Func>
+double ns_per_scope(Func&& func, std::size_t scopes_per_call)
+{
+  std::vector<double> rounds;
+  for (int r = 0; r < n_rounds; r++)
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (std::size_t i = 0u; i < scopes_per_round/scopes_per_call; i++)
+    { func(i); }
+    auto stop = std::chrono::high_resolution_clock::now();
+    rounds.push_back(std::chrono::duration<double, std::nano>(stop - start).count()/static_cast<double>(scopes_per_round));
+    Cppyplot::take_profile();
+  }
+  // median round, robust against preemption
+  std::nth_element(rounds.begin(), rounds.begin() + n_rounds/2, rounds.end());
+  return rounds[n_rounds/2];
+}
+
+volatile std::size_t sink = 0u;
+
+int main()
+{
+  const double empty_ns = ns_per_scope([](std::size_t i){ sink = i; }, 1u);
+  const double clock_ns = ns_per_scope([](std::size_t){ sink = static_cast<std::size_t>(Cppyplot::profile_clock()); }, 1u);
+
+  Cppyplot::set_profiling(false);
+  const double disabled_ns = ns_per_scope([](std::size_t i){ CPPYPLOT_SCOPE("disabled"); sink = i; }, 1u);
+
+  Cppyplot::set_profiling(true);
+  const double enabled_ns = ns_per_scope([](std::size_t i){ CPPYPLOT_SCOPE("enabled"); sink = i; }, 1u);
+  const double nested_ns  = ns_per_scope([](std::size_t i)
+  {
+    CPPYPLOT_SCOPE("depth 0");
+    {
+      CPPYPLOT_SCOPE("depth 1");
+      {
+        CPPYPLOT_SCOPE("depth 2");
+        {
+          CPPYPLOT_SCOPE("depth 3");
+          sink = i;
+        }
+      }
+    }
+  }, 4u);
+  Cppyplot::set_profiling(false);
+
+  std::cout << "empty loop        : " << empty_ns    << " ns\n"
+            << "clock read        : " << clock_ns    << " ns\n"
+            << "scope (disabled)  : " << disabled_ns << " ns\n"
+            << "scope (recorded)  : " << enabled_ns  << " ns\n"
+            << "scope (nested x4) : " << nested_ns   << " ns per scope\n";
+
+  std::vector<double> overhead_ns{clock_ns - empty_ns, disabled_ns - empty_ns, enabled_ns - empty_ns, nested_ns - empty_ns};
+  Cppyplot::cppyplot pyp;
+  pyp.raw(R"pyp(
+  plt.figure(figsize=(8,5))
+  plt.bar(["clock read", "scope (disabled)", "scope (recorded)", "scope (nested x4)"], overhead_ns, color="C0")
+  plt.ylabel("ns per scope (empty loop subtracted)", fontsize=12)
+  plt.grid(True, axis="y")
+  plt.show()
+  )pyp", _p(overhead_ns));
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,54 @@
+#include "../../include/cppyplot.hpp"
+
+#include <cmath>
+
+/*
+  Adaptive fidelity: 200k point scatter updates are sent at 100Hz, far faster than matplotlib can draw them.
+  The server reports its backlog, the client sends every 2nd/4th/8th point (x and y alike, as float32, float16) and skips updates
+  instead of lagging behind, and goes back to full fidelity once the server caught up.
+*/
+int main()
+{
+  if (!Cppyplot::cppyplot::set_adaptive())
+  { return EXIT_FAILURE; }
+  Cppyplot::cppyplot pyp;
+
+  pyp.raw(R"pyp(
+  plt.ion()
+  fig, ax = plt.subplots(figsize=(7,7))
+  ax.set_xlim(-1.5, 1.5)
+  ax.set_ylim(-1.5, 1.5)
+  points = ax.scatter([], [], s=1)
+  )pyp");
+  pyp.data_args();
+
+  constexpr std::size_t n_points = 200000u;
+  std::vector<double> x(n_points), y(n_points);
+  for (std::size_t step = 0u; step < 1500u; step++)
+  {
+    const double t = 0.01*static_cast<double>(step);
+    for (std::size_t i = 0u; i < n_points; i++)
+    {
+      const double phi = 2.0*3.14159265358979323846*static_cast<double>(i)/static_cast<double>(n_points);
+      const double r   = 1.0 + 0.3*std::sin(7.0*phi + t);
+      x[i] = r*std::cos(phi + 0.2*t);
+      y[i] = r*std::sin(phi + 0.2*t);
+    }
+
+    pyp.raw(R"pyp(
+    points.set_offsets(np.c_[x, y])
+    ax.set_title(f"{len(x)} points")
+    plt.pause(0.001)
+    )pyp", Cppyplot::_adaptive(_p(x)), Cppyplot::_adaptive(_p(y)));
+
+    if (step % 100u == 0u)
+    {
+      const auto stats = Cppyplot::cppyplot::fidelity_stats();
+      std::cout << "level " << stats.level << ", every " << stats.decimation << ". point, "
+                << stats.server_pending << " calls pending, " << 1e3*stats.server_eval << " ms per draw, "
+                << stats.calls_skipped << " updates skipped\n";
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,40 @@
+#include "../../include/cppyplot.hpp"
+
+#include <vector>
+#include <cmath>
+
+/*
+  Iso-lines of a 4096 x 4096 field are extracted on C++ side (Cppyplot::_contour),
+  only the polylines are sent instead of the 16M samples
+*/
+int main()
+{
+  constexpr std::size_t size = 4096u;
+  std::vector<std::vector<float>> field(size, std::vector<float>(size));
+  for (std::size_t r = 0u; r < size; r++)
+  {
+    for (std::size_t c = 0u; c < size; c++)
+    {
+      const float x = static_cast<float>(c)/512.0f, y = static_cast<float>(r)/512.0f;
+      field[r][c] = std::sin(x)*std::cos(0.8f*y) + 0.2f*std::sin(2.5f*x + 1.7f*y);
+    }
+  }
+
+  Cppyplot::cppyplot pyp;
+  pyp.raw(R"pyp(
+  plt.figure(figsize=(12,5))
+  plt.subplot(1, 2, 1)
+  iso.plot(cmap="coolwarm", linewidths=1.0)
+  plt.gca().set_aspect("equal")
+  plt.title("7 levels, %d polylines" % sum(len(lines) for lines in iso.lines), fontsize=12)
+
+  plt.subplot(1, 2, 2)
+  zero.plot(colors="k", linewidths=1.5)
+  plt.gca().set_aspect("equal")
+  plt.title("zero crossing, extent (0, 8) x (0, 8)", fontsize=12)
+  plt.show()
+  )pyp", Cppyplot::_contour(std::make_pair("iso"s, std::ref(field)), 7u),
+         Cppyplot::_contour(std::make_pair("zero"s, std::ref(field)), std::vector<double>{0.0}, {0.0, 8.0, 0.0, 8.0}));
+
+  return EXIT_SUCCESS;
+}
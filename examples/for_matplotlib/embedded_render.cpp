@@ -0,0 +1,65 @@
+#include "../../include/cppyplot.hpp"
+
+#include <cmath>
+#include <fstream>
+
+/*
+  Render to buffer: the server renders a windowless figure and returns its RGBA framebuffer, the 60Hz loop below
+  stands in for a GUI frame loop (ImGui, Qt) and "uploads" a frame only when a new one arrived. The last frame is
+  written to embedded_render.ppm.
+*/
+int main()
+{
+  if (!Cppyplot::cppyplot::enable_render())
+  { return EXIT_FAILURE; }
+  Cppyplot::cppyplot pyp;
+
+  pyp.raw(R"pyp(
+  fig  = render.figure("chart", 640, 360)
+  ax   = fig.add_subplot()
+  line, = ax.plot([], [])
+  ax.set_xlim(0, 2*np.pi)
+  ax.set_ylim(-1.1, 1.1)
+  ax.grid(True)
+  )pyp");
+  pyp.data_args();
+
+  std::vector<double> x(500), y(500);
+  std::uint64_t uploaded = 0u, uploads = 0u;
+  std::shared_ptr<const Cppyplot::rendered_frame> frame;
+  for (std::size_t step = 0u; step < 600u; step++)
+  {
+    // data changes at 20Hz, the frame loop runs at 60Hz
+    if (step % 3u == 0u)
+    {
+      for (std::size_t i = 0u; i < x.size(); i++)
+      {
+        x[i] = 2.0*3.14159265358979323846*static_cast<double>(i)/static_cast<double>(x.size() - 1u);
+        y[i] = std::sin(3.0*x[i] + 0.05*static_cast<double>(step));
+      }
+      pyp.raw(R"pyp(
+      line.set_data(x, y)
+      ax.set_title(f"step {step}")
+      )pyp", _p(x), _p(y), _p(step));
+    }
+
+    frame = Cppyplot::cppyplot::rendered("chart");
+    if ((frame != nullptr) && (frame->sequence != uploaded))
+    {
+      // glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, frame->width, frame->height, GL_RGBA, GL_UNSIGNED_BYTE, frame->rgba.data());
+      uploaded = frame->sequence;
+      uploads++;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(16));
+  }
+  std::cout << uploads << " frames uploaded in 600 display frames\n";
+
+  if (frame != nullptr)
+  {
+    std::ofstream ppm("embedded_render.ppm", std::ios::binary);
+    ppm << "P6\n" << frame->width << ' ' << frame->height << "\n255\n";
+    for (std::size_t i = 0u; i < frame->rgba.size(); i += 4u)
+    { ppm.write(reinterpret_cast<const char*>(&frame->rgba[i]), 3); }
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,49 @@
+#include "../../include/cppyplot.hpp"
+
+#include <vector>
+#include <random>
+
+/*
+  Histogram, 2D histogram and hexbin of 10M samples, binned on C++ side 
+  so only bin edges and counts are sent to python
+*/
+int main()
+{
+  Cppyplot::cppyplot pyp;
+
+  std::random_device seed;
+  std::mt19937 gen(seed());
+  std::normal_distribution<double> norm(0.0, 5.0);
+
+  std::vector<std::vector<double>> xy(10000000u, std::vector<double>(2));
+  for (auto& row : xy)
+  {
+    row[0] = norm(gen);
+    row[1] = 0.5*row[0] + norm(gen);
+  }
+
+  std::vector<double> x(xy.size());
+  for (std::size_t i = 0u; i < xy.size(); i++)
+  { x[i] = xy[i][0]; }
+
+  pyp.raw(R"pyp(
+  plt.figure(figsize=(15,5))
+  plt.subplot(1,3,1)
+  plt.stairs(*x, fill=True)
+  plt.title("_hist", fontsize=12)
+
+  plt.subplot(1,3,2)
+  counts, x_edges, y_edges = xy
+  plt.pcolormesh(x_edges, y_edges, counts.T, cmap="viridis")
+  plt.title("_hist2d", fontsize=12)
+
+  plt.subplot(1,3,3)
+  plt.hexbin(*xy_hex, **xy_hex_hexbin, cmap="viridis")
+  plt.title("_hexbin", fontsize=12)
+  plt.show()
+  )pyp", Cppyplot::_hist(_p(x), 100), 
+         Cppyplot::_hist2d(_p(xy), 100, 100, {-20.0, 20.0, -20.0, 20.0}), 
+         Cppyplot::_hexbin(std::make_pair("xy_hex"s, std::ref(xy)), 50));
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,35 @@
+#include "../../include/cppyplot.hpp"
+
+#include <cmath>
+
+/*
+  8k x 8k raster served as a tiled image pyramid, python side only fetches the tiles 
+  needed for the current view and fetches more on zoom/pan
+*/
+int main()
+{
+  constexpr std::size_t size = 8192u;
+  std::vector<std::vector<float>> field(size, std::vector<float>(size));
+  for (std::size_t r = 0u; r < size; r++)
+  {
+    for (std::size_t c = 0u; c < size; c++)
+    { field[r][c] = std::sin(static_cast<float>(r)*0.01F)*std::cos(static_cast<float>(c)*0.013F); }
+  }
+
+  Cppyplot::cppyplot pyp;
+
+  // has to stay alive while the plot window is open, it serves the tile requests
+  Cppyplot::image_pyramid pyramid(field, "tcp://127.0.0.1:5557", 256u);
+
+  pyp.raw(R"pyp(
+  plt.figure(figsize=(7,7))
+  pyramid.show(cmap="viridis", vmin=-1.0, vmax=1.0)
+  plt.title("8k x 8k field, zoom in to load full resolution tiles", fontsize=12)
+  plt.show()
+  )pyp", _p(pyramid));
+
+  std::cout << "Press enter to exit ...";
+  std::cin.get();
+
+  return EXIT_SUCCESS;
+}
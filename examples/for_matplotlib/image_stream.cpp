@@ -0,0 +1,44 @@
+#include "../../include/cppyplot.hpp"
+
+#include <cmath>
+#include <random>
+
+/*
+  Realtime occupancy grid, only the tiles that changed since the previous frame are sent (Cppyplot::_tiles)
+*/
+int main()
+{
+  std::random_device seed;
+  std::mt19937 gen(seed());
+  std::uniform_int_distribution<std::size_t> cell(0u, 399u);
+
+  std::vector<std::vector<std::uint8_t>> grid(400, std::vector<std::uint8_t>(400, 0u));
+
+  Cppyplot::cppyplot pyp;
+
+  pyp.raw(R"pyp(
+  plt.ion()
+  fig = plt.figure(figsize=(6,6))
+  grid_image = plt.imshow(grid, cmap="gray_r", vmin=0, vmax=255)
+  plt.title("Occupancy grid", fontsize=14)
+  )pyp", Cppyplot::_tiles(_p(grid), "grid_image"));
+
+  for (std::size_t frame = 0u; frame < 500u; frame++)
+  {
+    // a robot observing a few cells per frame
+    const std::size_t row = cell(gen), col = cell(gen);
+    for (std::size_t r = row; r < std::min<std::size_t>(row + 10u, 400u); r++)
+    {
+      for (std::size_t c = col; c < std::min<std::size_t>(col + 10u, 400u); c++)
+      { grid[r][c] = static_cast<std::uint8_t>(std::min(255, grid[r][c] + 60)); }
+    }
+
+    // python side patches the last frame and calls grid_image.set_data(grid)
+    pyp.raw(R"pyp(
+    fig.canvas.draw_idle()
+    plt.pause(0.01)
+    )pyp", Cppyplot::_tiles(_p(grid), "grid_image"));
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,70 @@
+#include "../../include/cppyplot.hpp"
+
+#include <cmath>
+
+/*
+  Interactive tuning: sliders in the plot window set the frequency and damping of a simulated oscillator,
+  clicking into the axes moves the start time of the simulation. Slider and click events are polled from the
+  event queue between steps, 'q' pressed in the window stops the loop (callback on the return channel thread).
+*/
+int main()
+{
+  if (!Cppyplot::cppyplot::enable_events())
+  { return EXIT_FAILURE; }
+  Cppyplot::cppyplot pyp;
+
+  std::atomic<bool> quit{false};
+  pyp.on_event("q", [&quit](const Cppyplot::plot_event& event)
+  {
+    if (event.type == Cppyplot::event_type::key)
+    { quit.store(true); }
+  });
+
+  pyp.raw(R"pyp(
+  plt.ion()
+  fig, ax = plt.subplots(figsize=(8,5))
+  fig.subplots_adjust(bottom=0.25)
+  line, = ax.plot([], [])
+  ax.set_xlim(0, 10)
+  ax.set_ylim(-1.1, 1.1)
+  ax.set_title("click to move the start, 'q' to quit")
+  freq    = Slider(fig.add_axes([0.15, 0.10, 0.7, 0.03]), "frequency", 0.1, 5.0, valinit=1.0)
+  damping = Slider(fig.add_axes([0.15, 0.05, 0.7, 0.03]), "damping", 0.0, 2.0, valinit=0.2)
+  events.widget(freq, "frequency")
+  events.widget(damping, "damping")
+  events.connect(fig)
+  plt.show(block=False)
+  )pyp");
+  pyp.data_args();
+
+  double frequency = 1.0, zeta = 0.2, start = 0.0;
+  std::vector<double> t(2000), y(2000);
+  while (!quit.load())
+  {
+    Cppyplot::plot_event event;
+    while (Cppyplot::cppyplot::poll_event(event))
+    {
+      if ((event.type == Cppyplot::event_type::widget) && (event.text() == "frequency"))
+      { frequency = event.value; }
+      else if ((event.type == Cppyplot::event_type::widget) && (event.text() == "damping"))
+      { zeta = event.value; }
+      else if ((event.type == Cppyplot::event_type::click) && (event.axes == 0))
+      { start = event.x; }
+    }
+
+    const double omega = 2.0*3.14159265358979323846*frequency;
+    for (std::size_t i = 0u; i < t.size(); i++)
+    {
+      t[i] = 10.0*static_cast<double>(i)/static_cast<double>(t.size() - 1u);
+      const double tau = std::max(t[i] - start, 0.0);
+      y[i] = (t[i] < start)? 0.0 : std::exp(-zeta*omega*tau)*std::cos(omega*tau);
+    }
+
+    pyp.raw(R"pyp(
+    line.set_data(t, y)
+    plt.pause(0.001)
+    )pyp", _p(t), _p(y));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,44 @@
+#include "../../include/cppyplot.hpp"
+
+#include <vector>
+#include <random>
+
+/*
+  Kernel density estimates of 10M samples computed on C++ side,
+  only the density grids are sent to python
+*/
+int main()
+{
+  Cppyplot::cppyplot pyp;
+
+  std::random_device seed;
+  std::mt19937 gen(seed());
+  std::normal_distribution<double> norm(0.0, 5.0);
+
+  std::vector<std::vector<double>> xy(10000000u, std::vector<double>(2));
+  for (auto& row : xy)
+  {
+    row[0] = norm(gen);
+    row[1] = 0.5*row[0] + norm(gen);
+  }
+
+  std::vector<double> x(xy.size());
+  for (std::size_t i = 0u; i < xy.size(); i++)
+  { x[i] = xy[i][0]; }
+
+  pyp.raw(R"pyp(
+  plt.figure(figsize=(12,5))
+  plt.subplot(1,2,1)
+  plt.plot(*x, linewidth=2)
+  plt.fill_between(*x, alpha=0.3)
+  plt.grid(True)
+  plt.title("_kde", fontsize=12)
+
+  plt.subplot(1,2,2)
+  plt.contourf(*xy, levels=10, cmap="viridis")
+  plt.title("_kde2d", fontsize=12)
+  plt.show()
+  )pyp", Cppyplot::_kde(_p(x)), Cppyplot::_kde2d(_p(xy), 128u));
+
+  return EXIT_SUCCESS;
+}
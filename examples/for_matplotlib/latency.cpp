@@ -0,0 +1,55 @@
+#include "../../include/cppyplot.hpp"
+
+#include <vector>
+#include <random>
+#include <thread>
+
+/*
+  Latency distribution recorded from several threads into an HDR histogram and a t-digest,
+  only buckets/centroids are sent to python and drawn as percentile curves and CDF
+*/
+int main()
+{
+  Cppyplot::cppyplot pyp;
+
+  Cppyplot::hdr_histogram latency_hdr;   // nanoseconds up to 1 hour, 3 significant digits
+  Cppyplot::tdigest       latency_digest;
+
+  std::vector<std::thread> workers;
+  for (unsigned int t = 0u; t < 4u; t++)
+  {
+    workers.emplace_back([&latency_hdr, &latency_digest, t]()
+    {
+      std::mt19937 gen(t);
+      std::lognormal_distribution<double> service_time(11.0, 0.8);
+      for (std::size_t i = 0u; i < 2000000u; i++)
+      {
+        const auto latency = std::chrono::nanoseconds(static_cast<std::int64_t>(service_time(gen)));
+        latency_hdr.record(latency);
+        latency_digest.record(latency);
+      }
+    });
+  }
+  for (auto& worker : workers)
+  { worker.join(); }
+
+  pyp.raw(R"pyp(
+  plt.figure(figsize=(12,5))
+  plt.subplot(1,2,1)
+  latency_hdr.plot_percentiles(label="hdr_histogram")
+  latency_digest.plot_percentiles(label="tdigest", linestyle="--")
+  plt.ylabel("latency [ns]", fontsize=12)
+  plt.legend()
+  plt.grid(True)
+
+  plt.subplot(1,2,2)
+  latency_hdr.plot_cdf()
+  plt.xscale("log")
+  plt.xlabel("latency [ns]", fontsize=12)
+  plt.title("p99 = %.0f ns" % latency_hdr.quantile(0.99), fontsize=12)
+  plt.grid(True)
+  plt.show()
+  )pyp", _p(latency_hdr), _p(latency_digest));
+
+  return EXIT_SUCCESS;
+}
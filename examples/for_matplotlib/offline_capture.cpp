@@ -0,0 +1,48 @@
+#include "../../include/cppyplot.hpp"
+
+#include <cmath>
+
+/*
+  Writes every plot call to the directory 'capture' instead of plotting (no python needed while running):
+    capture/call_000000/script.py, capture/call_000001/x.npy, capture/call_000001/y.npy, ...
+  inspect with numpy:   np.load("capture/call_000001/y.npy")
+  replay into a server: python include/cppyplot_replay.py capture
+  Cppyplot::offline_format::npz writes capture/session.npz instead, np.load("capture/session.npz")["call_000001/y.npy"]
+*/
+int main()
+{
+  if (!Cppyplot::cppyplot::set_offline("capture"))
+  { return EXIT_FAILURE; }
+  Cppyplot::cppyplot pyp;
+
+  pyp.raw(R"pyp(
+  plt.ion()
+  fig, ax = plt.subplots(figsize=(8,5))
+  line, = ax.plot([], [], 'b-')
+  ax.set_xlim(0, 2*np.pi)
+  ax.set_ylim(-1.5, 1.5)
+  ax.grid(True)
+  )pyp");
+  pyp.data_args();
+
+  std::vector<double> x(500u), y(500u);
+  for (std::size_t i = 0u; i < x.size(); i++)
+  { x[i] = 2.0*3.14159265358979323846*static_cast<double>(i)/static_cast<double>(x.size()); }
+
+  for (std::size_t frame = 0u; frame < 200u; frame++)
+  {
+    const double phase = 0.05*static_cast<double>(frame);
+    for (std::size_t i = 0u; i < y.size(); i++)
+    { y[i] = std::sin(x[i] + phase)*std::cos(0.3*phase); }
+
+    pyp.raw(R"pyp(
+    line.set_data(x, y)
+    ax.set_title(f"frame {frame}")
+    plt.pause(0.01)
+    )pyp", _p(x), _p(y), _p(frame));
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  }
+
+  Cppyplot::cppyplot::stop_offline();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,57 @@
+#include "../../include/cppyplot.hpp"
+
+#include <array>
+#include <cmath>
+
+/*
+  Oscilloscope mode: a simulated PID loop runs without any plotting calls,
+  its state is sampled in the background (Cppyplot::cppyplot::watch) and scrolls in two live scopes
+*/
+int main()
+{
+  double setpoint = 1.0;
+  double position = 0.0;
+  Cppyplot::seqlock<std::array<double, 3>> pid_terms;   // p, i, d written together, always read consistently
+
+  Cppyplot::cppyplot pyp;
+  pyp.watch(_p(position), 500.0, 5000u);
+  pyp.watch(_p(setpoint), 50.0, 500u);
+  pyp.watch(_p(pid_terms), 200.0, 2000u);
+
+  pyp.raw(R"pyp(
+  plt.ion()
+  fig, axes = plt.subplots(2, 1, figsize=(10,6), sharex=True)
+  position.show(axes[0], label="position")
+  setpoint.show(axes[0], label="setpoint", drawstyle="steps-post")
+  pid_terms.show(axes[1])
+  axes[0].legend(loc="upper left")
+  axes[1].legend(["p", "i", "d"], loc="upper left")
+  axes[1].set_xlabel("time [s]")
+  plt.pause(0.01)
+  )pyp");
+  pyp.data_args();
+
+  // 1 kHz control loop for 10 seconds, the setpoint changes every 2 seconds
+  constexpr double dt = 1e-3, kp = 8.0, ki = 2.0, kd = 0.6;
+  double velocity = 0.0, integral = 0.0, prev_position = 0.0;
+  auto next_step = std::chrono::steady_clock::now();
+  for (std::size_t step = 0u; step < 10000u; step++)
+  {
+    setpoint = (step/2000u % 2u == 0u) ? 1.0 : -0.5;
+    const double error      = setpoint - position;
+    integral               += error*dt;
+    const double derivative = (prev_position - position)/dt;   // on the measurement, no kick on setpoint steps
+    prev_position           = position;
+    pid_terms = std::array<double, 3>{kp*error, ki*integral, kd*derivative};
+
+    velocity += (kp*error + ki*integral + kd*derivative - 1.5*velocity)*dt;
+    position += velocity*dt;
+
+    next_step += std::chrono::microseconds(1000);
+    std::this_thread::sleep_until(next_step);
+  }
+
+  // watched variables go out of scope after main
+  pyp.unwatch();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,54 @@
+#include "../../include/cppyplot.hpp"
+
+#include <cmath>
+
+/*
+  Out-of-core plotting: a 1D wave simulation appends every step to field.npy (330MB here, raise n_steps past RAM),
+  python side maps the file with np.memmap and reads only the rows and columns selected by the decimating slice
+*/
+int main()
+{
+  constexpr std::size_t n_cells = 2048u, n_steps = 20000u;
+  Cppyplot::npy_file<double> field("field.npy", {n_cells});
+  if (!field.is_open())
+  { return EXIT_FAILURE; }
+
+  std::vector<double> u(n_cells, 0.0), u_prev(n_cells, 0.0), u_next(n_cells, 0.0);
+  for (std::size_t i = 0u; i < n_cells; i++)
+  { u[i] = u_prev[i] = std::exp(-0.5*std::pow((static_cast<double>(i) - 700.0)/20.0, 2.0)); }
+
+  Cppyplot::cppyplot pyp;
+  pyp.raw(R"pyp(
+  plt.ion()
+  fig, ax = plt.subplots(figsize=(8,6))
+  )pyp");
+  pyp.data_args();
+
+  constexpr double c2 = 0.25;   // (c dt/dx)^2
+  for (std::size_t step = 0u; step < n_steps; step++)
+  {
+    for (std::size_t i = 1u; i + 1u < n_cells; i++)
+    { u_next[i] = 2.0*u[i] - u_prev[i] + c2*(u[i - 1u] - 2.0*u[i] + u[i + 1u]); }
+    std::swap(u_prev, u);
+    std::swap(u, u_next);
+    field.append(u);
+
+    if ((step + 1u) % 2000u == 0u)
+    {
+      // at most ~500 x 512 values are read, whatever the size of the file
+      pyp.raw(R"pyp(
+      step = max(1, field.shape[0]//500)
+      ax.clear()
+      ax.imshow(field[::step, ::4], aspect="auto", origin="lower", cmap="RdBu_r", vmin=-1, vmax=1,
+                extent=(0, field.shape[1], 0, field.shape[0]))
+      ax.set_xlabel("cell")
+      ax.set_ylabel("step")
+      ax.set_title(f"{field.shape[0]} steps, {field.nbytes/2**20:.0f} MiB on disk")
+      plt.pause(0.01)
+      )pyp", _p(field));
+    }
+  }
+
+  field.close();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,42 @@
+#include "../../include/cppyplot.hpp"
+
+#include <vector>
+#include <random>
+#include <cmath>
+
+/*
+  5M point synthetic scan (x, y, z, intensity) downsampled on C++ side before the 3D scatter,
+  voxel centroids carry the mean intensity of their points
+*/
+int main()
+{
+  Cppyplot::cppyplot pyp;
+
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<double> uniform(-40.0, 40.0);
+  std::normal_distribution<double> noise(0.0, 0.05);
+
+  std::vector<std::array<double, 4>> scan(5000000u);
+  for (auto& point : scan)
+  {
+    point[0] = uniform(gen);
+    point[1] = uniform(gen);
+    point[2] = std::sin(0.2*point[0])*std::cos(0.15*point[1]) + noise(gen);
+    point[3] = std::abs(point[2]);
+  }
+
+  pyp.raw(R"pyp(
+  fig = plt.figure(figsize=(12,6))
+  ax = fig.add_subplot(1, 2, 1, projection="3d")
+  ax.scatter(scan[:,0], scan[:,1], scan[:,2], c=scan[:,3], s=1, cmap="viridis")
+  ax.set_title("voxel grid, %d points" % len(scan), fontsize=12)
+
+  ax = fig.add_subplot(1, 2, 2, projection="3d")
+  ax.scatter(scan_random[:,0], scan_random[:,1], scan_random[:,2], c=scan_random[:,3], s=1, cmap="viridis")
+  ax.set_title("random subset, %d points" % len(scan_random), fontsize=12)
+  plt.show()
+  )pyp", Cppyplot::_point_budget(_p(scan), 50000u),
+         Cppyplot::_point_budget(std::make_pair("scan_random"s, std::ref(scan)), 50000u, Cppyplot::point_sampling::random));
+
+  return EXIT_SUCCESS;
+}
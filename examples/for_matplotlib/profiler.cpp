@@ -0,0 +1,86 @@
+#include "../../include/cppyplot.hpp"
+
+#include <cmath>
+#include <random>
+
+/*
+  In-app profiling: a producer/consumer pipeline instrumented with CPPYPLOT_SCOPE,
+  the live timeline shows what every thread does, the flame graph where the time goes
+*/
+
+double simulate(std::size_t n)
+{
+  CPPYPLOT_SCOPE("simulate");
+  double acc = 0.0;
+  for (std::size_t i = 0u; i < n; i++)
+  { acc += std::sin(static_cast<double>(i)*1e-3); }
+  return acc;
+}
+
+void filter(std::vector<double>& samples)
+{
+  CPPYPLOT_SCOPE("filter");
+  for (std::size_t i = 1u; i < samples.size(); i++)
+  { samples[i] = 0.9*samples[i - 1u] + 0.1*samples[i]; }
+}
+
+int main()
+{
+  Cppyplot::cppyplot pyp;
+  pyp.profile("prof");
+
+  pyp.raw(R"pyp(
+  plt.ion()
+  fig, axes = plt.subplots(2, 1, figsize=(12,8))
+  prof.history = 2.0
+  prof.timeline(axes[0])
+  prof.flame(axes[1])
+  plt.pause(0.01)
+  )pyp");
+  pyp.data_args();
+
+  std::mutex queue_lock;
+  std::vector<std::vector<double>> queue;
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> workers;
+  for (std::size_t w = 0u; w < 3u; w++)
+  {
+    workers.emplace_back([&, w]()
+    {
+      std::mt19937 gen(static_cast<unsigned int>(w));
+      std::uniform_int_distribution<std::size_t> work(20000u, 200000u);
+      while (!done)
+      {
+        CPPYPLOT_SCOPE("produce");
+        std::vector<double> samples(1000u, simulate(work(gen)));
+        filter(samples);
+        {
+          CPPYPLOT_SCOPE("enqueue");
+          std::lock_guard<std::mutex> lock(queue_lock);
+          queue.push_back(std::move(samples));
+        }
+      }
+    });
+  }
+
+  for (std::size_t frame = 0u; frame < 500u; frame++)
+  {
+    CPPYPLOT_SCOPE("consume");
+    std::vector<std::vector<double>> batch;
+    {
+      CPPYPLOT_SCOPE("dequeue");
+      std::lock_guard<std::mutex> lock(queue_lock);
+      batch.swap(queue);
+    }
+    for (auto& samples : batch)
+    { filter(samples); }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  done = true;
+  for (auto& worker : workers)
+  { worker.join(); }
+  pyp.unwatch();
+  return EXIT_SUCCESS;
+}
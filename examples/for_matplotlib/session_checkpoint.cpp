@@ -0,0 +1,49 @@
+#include "../../include/cppyplot.hpp"
+
+#include <cmath>
+
+/*
+  Checkpoint and restore: the server accumulates a history of measurements and a running mean,
+  a checkpoint is written every 100 steps. Run again with --resume to restart the server from the last
+  checkpoint, the history and the figure continue where the previous run stopped instead of being resent.
+*/
+int main(int argc, char** argv)
+{
+  const bool resume = (argc > 1) && (std::string(argv[1]) == "--resume");
+  if (resume)
+  { Cppyplot::cppyplot::set_restore("checkpoint"); }
+  Cppyplot::cppyplot pyp;
+
+  if (!resume)
+  {
+    pyp.raw(R"pyp(
+    plt.ion()
+    fig, ax = plt.subplots(figsize=(8,4))
+    history = []
+    mean    = np.zeros(256)
+    line,   = ax.plot(mean)
+    ax.set_ylim(-1.5, 1.5)
+    )pyp");
+    pyp.data_args();
+  }
+
+  std::vector<double> sample(256);
+  for (std::size_t step = 0u; step < 500u; step++)
+  {
+    for (std::size_t i = 0u; i < sample.size(); i++)
+    { sample[i] = std::sin(0.05*static_cast<double>(i)) + 0.3*std::sin(0.7*static_cast<double>(step*i)); }
+
+    pyp.raw(R"pyp(
+    history.append(sample)
+    mean = mean + (sample - mean)/len(history)
+    line.set_ydata(mean)
+    ax.set_title(f"{len(history)} samples")
+    plt.pause(0.001)
+    )pyp", _p(sample));
+
+    if (step % 100u == 99u)
+    { Cppyplot::cppyplot::checkpoint("checkpoint"); }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,46 @@
+#include "../../include/cppyplot.hpp"
+
+#include <cmath>
+
+/*
+  Records a live plotting session to session.rec (+ session.rec.idx), replay it without rerunning this program:
+    python include/cppyplot_replay.py session.rec              (original speed)
+    python include/cppyplot_replay.py session.rec --speed 4    (4x)
+    python include/cppyplot_replay.py session.rec --start 3.5  (fast forward to 3.5s)
+*/
+int main()
+{
+  Cppyplot::cppyplot pyp;
+  if (!Cppyplot::cppyplot::record_session("session.rec"))
+  { return EXIT_FAILURE; }
+
+  pyp.raw(R"pyp(
+  plt.ion()
+  fig, ax = plt.subplots(figsize=(8,5))
+  line, = ax.plot([], [], 'b-')
+  ax.set_xlim(0, 2*np.pi)
+  ax.set_ylim(-1.5, 1.5)
+  ax.grid(True)
+  )pyp");
+
+  std::vector<double> x(500u), y(500u);
+  for (std::size_t i = 0u; i < x.size(); i++)
+  { x[i] = 2.0*3.14159265358979323846*static_cast<double>(i)/static_cast<double>(x.size()); }
+
+  for (std::size_t frame = 0u; frame < 200u; frame++)
+  {
+    const double phase = 0.05*static_cast<double>(frame);
+    for (std::size_t i = 0u; i < y.size(); i++)
+    { y[i] = std::sin(x[i] + phase)*std::cos(0.3*phase); }
+
+    pyp.raw(R"pyp(
+    line.set_data(x, y)
+    ax.set_title(f"frame {frame}")
+    plt.pause(0.01)
+    )pyp", _p(x), _p(y), _p(frame));
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  }
+
+  Cppyplot::cppyplot::stop_recording();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,40 @@
+#include "../../include/cppyplot.hpp"
+
+#include <vector>
+
+/*
+  Sparsity pattern of a 2D Laplacian (1M x 1M), Eigen sparse matrices are sent as their 
+  compressed arrays and arrive in python as scipy.sparse matrices without densifying
+*/
+int main()
+{
+  Cppyplot::cppyplot pyp;
+
+  const int grid = 1000;
+  const int n    = grid*grid;
+  std::vector<Eigen::Triplet<double>> entries;
+  entries.reserve(5u*static_cast<std::size_t>(n));
+  for (int r = 0; r < grid; r++)
+  {
+    for (int c = 0; c < grid; c++)
+    {
+      const int i = r*grid + c;
+      entries.emplace_back(i, i, 4.0);
+      if (c > 0)        { entries.emplace_back(i, i - 1, -1.0); }
+      if (c < grid - 1) { entries.emplace_back(i, i + 1, -1.0); }
+      if (r > 0)        { entries.emplace_back(i, i - grid, -1.0); }
+      if (r < grid - 1) { entries.emplace_back(i, i + grid, -1.0); }
+    }
+  }
+  Eigen::SparseMatrix<double> laplacian(n, n);
+  laplacian.setFromTriplets(entries.begin(), entries.end());
+
+  pyp.raw(R"pyp(
+  plt.figure(figsize=(6,6))
+  plt.spy(laplacian[:3000, :3000], markersize=0.5)
+  plt.title("%d x %d, %d non zeros" % (laplacian.shape[0], laplacian.shape[1], laplacian.nnz), fontsize=12)
+  plt.show()
+  )pyp", _p(laplacian));
+
+  return EXIT_SUCCESS;
+}
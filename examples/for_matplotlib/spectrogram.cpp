@@ -0,0 +1,51 @@
+#include "../../include/cppyplot.hpp"
+
+#include <vector>
+#include <random>
+#include <cmath>
+
+/*
+  Live chirp with noise, the STFT columns are computed on C++ side as samples arrive (Cppyplot::spectrogram)
+  and python side scrolls a waterfall image of the last 400 columns
+*/
+int main()
+{
+  constexpr double sample_rate = 8000.0;
+  constexpr double pi = 3.14159265358979323846;
+  std::mt19937 gen(0);
+  std::normal_distribution<double> noise(0.0, 0.5);
+
+  Cppyplot::spectrogram spec(512u, 128u, sample_rate, 400u);
+  Cppyplot::cppyplot pyp;
+
+  pyp.raw(R"pyp(
+  plt.ion()
+  fig = plt.figure(figsize=(10,5))
+  image = spec.show(cmap="magma")
+  plt.colorbar(image, label="dB/Hz")
+  plt.xlabel("time [s]")
+  plt.ylabel("frequency [Hz]")
+  )pyp", _p(spec));
+
+  std::vector<double> block(400u);
+  double t = 0.0;
+  for (std::size_t frame = 0u; frame < 500u; frame++)
+  {
+    // frequency sweeps from 200 Hz to 3.2 kHz every 4 seconds
+    for (auto& sample : block)
+    {
+      const double sweep = std::fmod(t, 4.0);
+      sample = std::sin(2.0*pi*(200.0*sweep + 375.0*sweep*sweep)) + noise(gen);
+      t += 1.0/sample_rate;
+    }
+    spec.push(block);
+
+    // only the columns computed since the last frame are sent
+    pyp.raw(R"pyp(
+    fig.canvas.draw_idle()
+    plt.pause(0.01)
+    )pyp", _p(spec));
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,53 @@
+#include "../../include/cppyplot.hpp"
+
+#include <vector>
+#include <array>
+#include <cmath>
+
+/*
+  Torus mesh sent as vertex and face buffers, faces use std::size_t indices which are narrowed to uint32,
+  the python side builds the surface (plot_trisurf) and the polygon collection (poly3d) in a single call
+*/
+int main()
+{
+  Cppyplot::cppyplot pyp;
+
+  constexpr std::size_t n_major = 96u, n_minor = 48u;
+  constexpr double pi = 3.14159265358979323846;
+  std::vector<std::array<float, 3>> vertices;
+  std::vector<std::array<std::size_t, 3>> faces;
+  for (std::size_t i = 0u; i < n_major; i++)
+  {
+    const double u = 2.0*pi*static_cast<double>(i)/static_cast<double>(n_major);
+    for (std::size_t j = 0u; j < n_minor; j++)
+    {
+      const double v = 2.0*pi*static_cast<double>(j)/static_cast<double>(n_minor);
+      vertices.push_back({static_cast<float>((3.0 + std::cos(v))*std::cos(u)), 
+                          static_cast<float>((3.0 + std::cos(v))*std::sin(u)), 
+                          static_cast<float>(std::sin(v))});
+
+      const std::size_t a = i*n_minor + j;
+      const std::size_t b = ((i + 1u)%n_major)*n_minor + j;
+      const std::size_t c = ((i + 1u)%n_major)*n_minor + (j + 1u)%n_minor;
+      const std::size_t d = i*n_minor + (j + 1u)%n_minor;
+      faces.push_back({a, b, c});
+      faces.push_back({a, c, d});
+    }
+  }
+
+  pyp.raw(R"pyp(
+  fig = plt.figure(figsize=(12,6))
+  ax = fig.add_subplot(1, 2, 1, projection="3d")
+  torus.plot_trisurf(ax, cmap="viridis", linewidth=0.0)
+  ax.set_zlim(-3, 3)
+  ax.set_title("plot_trisurf, %d faces (%s indices)" % (len(torus.faces), torus.faces.dtype), fontsize=12)
+
+  ax = fig.add_subplot(1, 2, 2, projection="3d")
+  torus.poly3d(ax, facecolor="lightsteelblue", edgecolor="k", linewidth=0.1)
+  ax.set_zlim(-3, 3)
+  ax.set_title("Poly3DCollection", fontsize=12)
+  plt.show()
+  )pyp", Cppyplot::_mesh(std::make_pair("torus"s, std::ref(vertices)), faces, true));
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,58 @@
+#include "../../include/cppyplot.hpp"
+
+#include <cmath>
+#include <random>
+
+/*
+  Triggered capture: a simulated 1 MHz ADC stream with rare glitches is recorded continuously,
+  only the 200us before and 600us after every glitch are sent and overlaid
+*/
+int main()
+{
+  constexpr double sample_rate = 1e6;
+  Cppyplot::triggered_capture<float> adc(200u, 600u, 8u, sample_rate);
+  adc.on_threshold(1.5, Cppyplot::trigger_edge::rising);
+  adc.set_holdoff(10000u);
+
+  Cppyplot::cppyplot pyp;
+  pyp.capture(_p(adc));
+
+  pyp.raw(R"pyp(
+  plt.ion()
+  fig, ax = plt.subplots(figsize=(10,5))
+  adc.show(ax, overlay=True, color="C3")
+  ax.set_xlabel("time since trigger [s]")
+  plt.pause(0.01)
+  )pyp");
+  pyp.data_args();
+
+  // 5 seconds of samples in 1ms blocks, a ringing glitch every ~0.7 seconds
+  std::mt19937 gen(42);
+  std::normal_distribution<float> noise(0.0f, 0.05f);
+  std::uniform_int_distribution<std::size_t> glitch_gap(500000u, 900000u);
+  std::size_t next_glitch = glitch_gap(gen);
+  auto next_block = std::chrono::steady_clock::now();
+  for (std::size_t i = 0u; i < 5000000u; i++)
+  {
+    const double t   = static_cast<double>(i)/sample_rate;
+    float sample     = static_cast<float>(std::sin(2.0*3.14159265358979323846*1e3*t)) + noise(gen);
+    if (i >= next_glitch)
+    {
+      const double dt = static_cast<double>(i - next_glitch)/sample_rate;
+      sample += static_cast<float>(3.0*std::exp(-dt*2e4)*std::cos(2.0*3.14159265358979323846*5e4*dt));
+      if (dt > 5e-4)
+      { next_glitch = i + glitch_gap(gen); }
+    }
+    adc.push(sample);
+
+    if ((i % 1000u) == 999u)
+    {
+      next_block += std::chrono::milliseconds(1);
+      std::this_thread::sleep_until(next_block);
+    }
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  pyp.unwatch();
+  return EXIT_SUCCESS;
+}
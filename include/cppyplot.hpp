@@ -10,24 +10,61 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <deque>
+#include <unordered_map>
 #include <iostream>
 #include <numeric>
+#include <array>
+#include <complex>
+#include <tuple>
+#include <sstream>
+#include <cstring>
+#include <cctype>
+#include <cstdio>
+#include <type_traits>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <random>
+
+#if defined(_MSC_VER)
+  #include <intrin.h>
+#elif defined(__x86_64__)
+  #include <x86intrin.h>
+#endif
 
 #include <zmq.hpp>
 #include <zmq_addon.hpp>
 
 #include <cstdlib>
 #include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 #include <chrono>
 #include <utility>
 #include <filesystem>
 
+// shared memory for rendered frames, posix only (windows receives them inline, windows.h stays out of this header)
+#if !(defined(_WIN32) || defined(_WIN64))
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+  #define CPPYPLOT_SHARED_FRAMES
+#endif
+
 // Eigen
 #if __has_include(<Eigen/Core>)
   #include <Eigen/Core>
+  #include <Eigen/SparseCore>
   #define EIGEN_AVAILABLE
 #elif __has_include (<Eigen/Eigen/Core>)
   #include <Eigen/Eigen/Core>
+  #include <Eigen/Eigen/SparseCore>
   #define EIGEN_AVAILABLE
 #endif
 
@@ -36,6 +73,7 @@ using namespace std::string_literals;
 
 #define PYTHON_PATH "C:/Anaconda3/python.exe"
 #define HOST_ADDR "tcp://127.0.0.1:5555"
+#define FEEDBACK_ADDR "tcp://127.0.0.1:5556"
 
 template <std::size_t ... indices>
 decltype(auto) build_string(const char * str, 
@@ -65,6 +103,26 @@ std::string shape_str(const T& shape);
 
 #include "cppyplot_types.h"
 #include "cppyplot_container_support.h"
+#include "cppyplot_parallel.h"
+#include "cppyplot_channel.h"
+#include "cppyplot_fidelity.h"
+#include "cppyplot_encoding.h"
+#include "cppyplot_colormaps.h"
+#include "cppyplot_image.h"
+#include "cppyplot_stats.h"
+#include "cppyplot_sketch.h"
+#include "cppyplot_points.h"
+#include "cppyplot_mesh.h"
+#include "cppyplot_spectrogram.h"
+#include "cppyplot_contour.h"
+#include "cppyplot_session.h"
+#include "cppyplot_offline.h"
+#include "cppyplot_memmap.h"
+#include "cppyplot_watch.h"
+#include "cppyplot_trigger.h"
+#include "cppyplot_profiler.h"
+#include "cppyplot_events.h"
+#include "cppyplot_render.h"
 
 class cppyplot{
   private:
@@ -73,11 +131,13 @@ class cppyplot{
     static bool is_zmq_established_;
     static std::string python_path_;
     static std::string zmq_ip_addr_;
+    static std::string restore_path_;
+    static bool implicit_axis_;
     std::stringstream plot_cmds_;
   public:
     cppyplot()
     {
-      if (cppyplot::is_zmq_established_ == false)
+      if ((cppyplot::is_zmq_established_ == false) && !offline().is_open())
       {
         cppyplot::socket_.bind(cppyplot::zmq_ip_addr_);
         std::this_thread::sleep_for(100ms);
@@ -93,6 +153,17 @@ class cppyplot{
         server_file_spawn += path.parent_path().string();
         server_file_spawn += "/cppyplot_server.py "s;
         server_file_spawn.append(cppyplot::zmq_ip_addr_);
+        if (server_channel().is_open())
+        {
+          server_file_spawn += " "s;
+          server_file_spawn.append(server_channel().address());
+        }
+        if (!cppyplot::restore_path_.empty())
+        {
+          server_file_spawn += " --restore \""s;
+          server_file_spawn.append(cppyplot::restore_path_);
+          server_file_spawn += "\""s;
+        }
 
 #if defined(__unix__)
         server_file_spawn += " &"s;
@@ -115,8 +186,19 @@ class cppyplot{
     static void set_host_ip(const std::string& host_ip) noexcept
     { cppyplot::zmq_ip_addr_ = host_ip; }
 
+    static void set_implicit_axis(bool enable) noexcept
+    { cppyplot::implicit_axis_ = enable; }
+
+    static void set_num_threads(std::size_t n_threads) noexcept
+    { parallel_threads() = std::max<std::size_t>(n_threads, 1u); }
+
     static void zmq_kill_command()
     {
+      watches().stop();
+      fidelity().stop();
+      server_channel().close();
+      stop_recording();
+      stop_offline();
       if (cppyplot::is_zmq_established_ == true)
       {
         // if the python server is spawned through this class instance, then send exit command
@@ -128,6 +210,103 @@ class cppyplot{
       }
     }
 
+    /*
+      * Records every frame sent from now on to 'path' (and the seek index to 'path'.idx),
+      * replay with: python cppyplot_replay.py path [--speed N | --speed max] [--start seconds]
+    */
+    static bool record_session(const std::string& path)
+    {
+      std::lock_guard<std::mutex> socket_lock(send_lock());
+      return recorder().open(path);
+    }
+
+    static void stop_recording()
+    {
+      std::lock_guard<std::mutex> socket_lock(send_lock());
+      recorder().close();
+    }
+
+    /*
+      * Writes every plot call to 'directory' instead of sending it (hosts without python),
+      * npy: directory/call_000042/<name>.npy, npz: directory/session.npz (np.load(path)["call_000042/<name>"]),
+      * replay with: python cppyplot_replay.py directory [--speed N | --speed max]
+      * Call before the first cppyplot instance, no server is spawned while offline.
+    */
+    static bool set_offline(const std::string& directory, offline_format format = offline_format::npy)
+    {
+      static std::once_flag exit_registered;
+      std::call_once(exit_registered, [](){ std::atexit(zmq_kill_command); });
+      std::lock_guard<std::mutex> socket_lock(send_lock());
+      return offline().open(directory, format);
+    }
+
+    static void stop_offline()
+    {
+      std::lock_guard<std::mutex> socket_lock(send_lock());
+      offline().close();
+    }
+
+    /*
+      * Adapts the fidelity to the server backlog (see cppyplot_fidelity.h), the spawned server publishes
+      * its status to the return channel bound at 'feedback_addr'. Call before the first cppyplot instance.
+    */
+    static bool set_adaptive(const std::string& feedback_addr = FEEDBACK_ADDR)
+    { return fidelity().enable(feedback_addr); }
+
+    static fidelity_state fidelity_stats()
+    { return fidelity().state(); }
+
+    /*
+      * Receives GUI events (clicks, keys, picks, widget changes) from the plot window over the return channel
+      * bound at 'feedback_addr' (see cppyplot_events.h). Call before the first cppyplot instance.
+    */
+    static bool enable_events(const std::string& feedback_addr = FEEDBACK_ADDR)
+    { return plot_events().enable(feedback_addr); }
+
+    // 'callback' runs on the return channel thread for every event, keep it short
+    void on_event(std::function<void(const plot_event&)> callback)
+    { plot_events().add_callback(std::string{}, std::move(callback)); }
+
+    // 'callback' runs for the events of the widget, key or picked artist called 'name'
+    void on_event(const std::string& name, std::function<void(const plot_event&)> callback)
+    { plot_events().add_callback(name, std::move(callback)); }
+
+    // oldest queued event, false when there is none (poll from one thread only)
+    static bool poll_event(plot_event& event) noexcept
+    { return plot_events().poll(event); }
+
+    static std::uint64_t dropped_events() noexcept
+    { return plot_events().dropped(); }
+
+    /*
+      * Receives the figures the server renders for embedding (render.figure/render.attach in plot scripts, see cppyplot_render.h)
+      * over the return channel bound at 'feedback_addr'. Call before the first cppyplot instance.
+    */
+    static bool enable_render(const std::string& feedback_addr = FEEDBACK_ADDR)
+    { return rendered_frames().enable(feedback_addr); }
+
+    // latest RGBA frame of the figure 'name' (nullptr before the first one), compare its sequence to skip unchanged frames
+    static std::shared_ptr<const rendered_frame> rendered(const std::string& name)
+    { return rendered_frames().latest(name); }
+
+    /*
+      * Snapshots the symbols plot calls created on the server (data, history lists, figures, derived arrays) to 'directory',
+      * numpy arrays as .npy blocks that are memory mapped on restore. Runs in order with the plot calls, not recorded or captured offline.
+    */
+    static void checkpoint(const std::string& directory)
+    { send_command("checkpoint|", directory); }
+
+    // restores the latest checkpoint in 'directory' into the running server
+    static void restore(const std::string& directory)
+    { send_command("restore|", directory); }
+
+    // the spawned server restores the latest checkpoint in 'directory' before the first plot call, call before the first cppyplot instance
+    static void set_restore(const std::string& directory)
+    {
+      std::error_code error;
+      cppyplot::restore_path_ = std::filesystem::absolute(directory, error).string();
+    }
+
     inline void push(const std::string& cmds)
     { plot_cmds_ << cmds << '\n'; }
 
@@ -147,8 +326,77 @@ class cppyplot{
       data_args(std::forward<std::pair<std::string, Val_t>>(args)...);
     }
 
+    /*
+      * Oscilloscope mode, 'arg' (or the value returned by 'getter') is sampled at rate_hz on a background thread 
+      * and streamed to the python Scope of the same name which keeps the last 'history' samples.
+      * Scalars, std::array of scalars and Cppyplot::seqlock of those can be watched.
+    */
+    template<typename T>
+    void watch(std::pair<std::string, T&>&& arg, double rate_hz, std::size_t history = 10000u)
+    {
+      const T& value = arg.second;
+      add_watch<T>(arg.first, [&value](char* out){ read_consistent(value, out); }, rate_hz, history);
+    }
+
+    template<typename T>
+    void watch(std::pair<std::string, seqlock<T>&>&& arg, double rate_hz, std::size_t history = 10000u)
+    {
+      const seqlock<T>& value = arg.second;
+      add_watch<T>(arg.first, [&value](char* out){ const T sample = value.load(); std::memcpy(out, &sample, sizeof(T)); }, 
+                   rate_hz, history);
+    }
+
+    template<typename Getter>
+    void watch(const std::string& name, Getter&& getter, double rate_hz, std::size_t history = 10000u)
+    {
+      using T = std::decay_t<std::invoke_result_t<Getter&>>;
+      add_watch<T>(name, [getter = std::forward<Getter>(getter)](char* out) mutable { const T sample = getter(); std::memcpy(out, &sample, sizeof(T)); }, 
+                   rate_hz, history);
+    }
+
+    /*
+      * Triggered capture, windows completed by 'arg' are sent from the background sampler as soon as they are ready,
+      * nothing is sent while no trigger fires. Python side accumulates them in the Capture of the same name.
+      * Remove with pyp.unwatch(name).
+    */
     template<typename T>
-    inline std::string create_header(const std::string& key, const T& cont) noexcept
+    void capture(std::pair<std::string, triggered_capture<T>&>&& arg)
+    {
+      const triggered_capture<T>& capture = arg.second;
+      auto entry   = std::make_unique<watch_entry>();
+      entry->name  = arg.first;
+      entry->ready = [&capture](){ return capture.pending() > 0u; };
+      entry->send  = [&capture](watch_entry& pending){ send_container(pending.name, capture); };
+      watches().add(std::move(entry));
+    }
+
+    /*
+      * Enables CPPYPLOT_SCOPE recording, the scopes of all threads are sent in batches from the background sampler
+      * to the python Profile of the given name. Remove with pyp.unwatch(name), recording stops with Cppyplot::set_profiling(false).
+    */
+    void profile(const std::string& name = "profile")
+    {
+      profiler().ns_per_tick();
+      auto entry   = std::make_unique<watch_entry>();
+      entry->name  = name;
+      entry->ready = [](){ return profiler().pending(); };
+      entry->send  = [](watch_entry& pending){ send_container(pending.name, take_profile()); };
+      watches().add(std::move(entry));
+      set_profiling(true);
+    }
+
+    void unwatch(const std::string& name)
+    { watches().remove(name); }
+
+    void unwatch()
+    { watches().stop(); }
+
+    template<typename T>
+    inline static std::string create_header(const std::string& key, const T& cont) noexcept
+    { return create_header(key, cont, container_encoding(cont)); }
+
+    template<typename T>
+    inline static std::string create_header(const std::string& key, const T& cont, const std::string& encoding) noexcept
     {
       auto elem_type = unpack_type<T>();
       std::string header{"data|"};
@@ -158,7 +406,7 @@ class cppyplot{
       header.append("|");
 
       // container element type (float or int or ...)
-      header += std::string{elem_type.typestr};
+      header += dtype_str(elem_type);
       header.append("|");
 
       // total number of elements in the container
@@ -167,32 +415,122 @@ class cppyplot{
 
       // shape of the container 
       header += shape_str(container_shape(cont));
+      header.append("|");
+
+      // payload encoding (raw, bits, ...)
+      header += encoding;
+      header.append("|");
+
+      // number of payload frames following the header
+      header += std::to_string(container_frames_v<T>);
 
       return header;
     }
 
+    // server commands bypass the recorder and offline capture
+    static void send_command(const std::string& command, const std::string& directory)
+    {
+      std::error_code error;
+      const std::string message = command + std::filesystem::absolute(directory, error).string();
+      std::lock_guard<std::mutex> socket_lock(send_lock());
+      if (cppyplot::is_zmq_established_)
+      {
+        zmq::message_t msg(message.data(), message.size());
+        cppyplot::socket_.send(msg, zmq::send_flags::none);
+      }
+    }
+
+    // every frame is sent through here with send_lock() held, payload frames follow a header
+    static void send_frame(zmq::message_t& frame, bool payload = false)
+    {
+      if (recorder().is_open())
+      { recorder().write(frame, payload); }
+      if (offline().is_open())
+      {
+        offline().write(frame, payload);
+        return;
+      }
+      cppyplot::socket_.send(frame, zmq::send_flags::none);
+    }
+
     template <typename T>
-    void send_container(const std::string& key, const T& cont)
+    static void send_container(const std::string& key, const T& cont)
     { 
+      if constexpr (is_arange_candidate_v<T>)
+      {
+        zmq::message_t axis_payload;
+        if (cppyplot::implicit_axis_ && !offline().is_open() && fill_arange_buffer(cont, axis_payload))
+        {
+          std::string axis_header{create_header(key, cont, "arange")};
+          zmq::message_t msg(axis_header.c_str(), axis_header.length());
+          send_frame(msg);
+          send_frame(axis_payload, true);
+          return;
+        }
+      }
+
       std::string data_header{create_header(key, cont)};
       zmq::message_t msg(data_header.c_str(), data_header.length());
-      cppyplot::socket_.send(msg, zmq::send_flags::none);
+      send_frame(msg);
 
-      zmq::message_t payload;
-      fill_zmq_buffer(cont, payload);
-      cppyplot::socket_.send(payload, zmq::send_flags::none);
+      if constexpr (container_frames_v<T> == 1u)
+      {
+        zmq::message_t payload;
+        fill_zmq_buffer(cont, payload);
+        send_frame(payload, true);
+      }
+      else
+      {
+        for (std::size_t frame = 0u; frame < container_frames_v<T>; frame++)
+        {
+          zmq::message_t payload;
+          fill_zmq_buffer(cont, frame, payload);
+          send_frame(payload, true);
+        }
+      }
+    }
+
+    template<typename T, typename Sampler>
+    void add_watch(const std::string& name, Sampler&& sampler, double rate_hz, std::size_t history)
+    {
+      using elem_t = typename watch_elem<T>::type;
+      static_assert(std::is_trivially_copyable_v<T> && is_scalar_v<elem_t> && (sizeof(T) % sizeof(elem_t) == 0u),
+                    "watched values have to be scalars or fixed size arrays of scalars");
+
+      auto entry          = std::make_unique<watch_entry>();
+      entry->name         = name;
+      entry->width        = sizeof(T)/sizeof(elem_t);
+      entry->sample_bytes = sizeof(T);
+      entry->history      = std::max<std::size_t>(history, 1u);
+      entry->period       = std::chrono::nanoseconds(static_cast<std::int64_t>(1e9/std::max(rate_hz, 1e-3)));
+      entry->sample       = std::forward<Sampler>(sampler);
+      entry->send         = [](watch_entry& pending){ send_container(pending.name, watch_batch<elem_t>{pending}); };
+      watches().add(std::move(entry));
     }
 
     template<typename... Val_t>
     void data_args(std::pair<std::string, Val_t>&&... args)
     {
+      // while the server lags, calls with containers are limited to its rate (adaptive fidelity)
+      if constexpr (sizeof...(Val_t) > 0u)
+      {
+        if (!fidelity().admit())
+        {
+          plot_cmds_.str("");
+          return;
+        }
+      }
+
+      std::lock_guard<std::mutex> socket_lock(send_lock());
+      begin_message();
       (send_container(args.first, args.second), ...);
 
       zmq::message_t cmds(plot_cmds_.str());
-      cppyplot::socket_.send(cmds, zmq::send_flags::none);
+      send_frame(cmds);
 
       zmq::message_t final("finalize", 8);
-      cppyplot::socket_.send(final, zmq::send_flags::none);
+      send_frame(final);
+      fidelity().sent();
 
       /* reset */
       plot_cmds_.str("");
@@ -205,6 +543,8 @@ zmq::socket_t  cppyplot::socket_              = zmq::socket_t(cppyplot::context_
 bool           cppyplot::is_zmq_established_  = false;
 std::string    cppyplot::python_path_{PYTHON_PATH};
 std::string    cppyplot::zmq_ip_addr_{HOST_ADDR};
+std::string    cppyplot::restore_path_;
+bool           cppyplot::implicit_axis_       = true;
 
 // utility functions
 auto non_empty_line_idx(const std::string_view in_str)
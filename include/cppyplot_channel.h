@@ -0,0 +1,107 @@
+#ifndef _CPPYPLOT_CHANNEL_H_
+#define _CPPYPLOT_CHANNEL_H_
+
+/*
+  * Return channel from the server to C++: the spawned cppyplot_server.py publishes to a SUB socket bound here
+  * (its address is passed to the server as 2nd argument). Used for the server status (adaptive fidelity),
+  * GUI events and rendered frames. A background thread receives the messages and hands them to the handler of their kind,
+  * handlers run on that thread as soon as a message arrives.
+  * message: kind (uint32) | payload
+*/
+enum class channel_kind : std::uint32_t { status = 0u, event = 1u, frame = 2u };
+
+class return_channel{
+  public:
+    using handler_t = std::function<void(const char*, std::size_t)>;
+
+  private:
+    std::mutex                       lock_;   // guards handlers_
+    std::array<handler_t, 3>         handlers_;
+    std::string                      address_;
+    std::unique_ptr<zmq::context_t>  context_;
+    std::unique_ptr<zmq::socket_t>   socket_;
+    std::atomic<bool>                running_{false};
+    std::thread                      thread_;
+
+    void receive()
+    {
+      while (running_.load())
+      {
+        zmq::message_t message;
+        // times out every 50ms (rcvtimeo) to check running_
+        if (!socket_->recv(message, zmq::recv_flags::none) || (message.size() < sizeof(std::uint32_t)))
+        { continue; }
+        std::uint32_t kind;
+        std::memcpy(&kind, message.data(), sizeof(kind));
+        if (kind >= handlers_.size())
+        { continue; }
+
+        std::lock_guard<std::mutex> lock(lock_);
+        if (handlers_[kind])
+        { handlers_[kind](static_cast<const char*>(message.data()) + sizeof(kind), message.size() - sizeof(kind)); }
+      }
+    }
+
+  public:
+    return_channel() = default;
+    return_channel(const return_channel&) = delete;
+    return_channel& operator=(const return_channel&) = delete;
+    ~return_channel()
+    { close(); }
+
+    // binds the socket the server publishes to, an open channel keeps its address.
+    // false when the address can not be bound (in use, malformed), the channel stays closed
+    bool open(const std::string& address)
+    {
+      if (running_.load())
+      { return true; }
+      address_ = address;
+      context_ = std::make_unique<zmq::context_t>(1);
+      socket_  = std::make_unique<zmq::socket_t>(*context_, zmq::socket_type::sub);
+      socket_->set(zmq::sockopt::subscribe, "");
+      socket_->set(zmq::sockopt::rcvtimeo, 50);
+      socket_->set(zmq::sockopt::linger, 0);
+      try
+      { socket_->bind(address_); }
+      catch (const zmq::error_t& error)
+      {
+        (void)error;
+        socket_.reset();
+        context_.reset();
+        address_.clear();
+        return false;
+      }
+      running_.store(true);
+      thread_ = std::thread(&return_channel::receive, this);
+      return true;
+    }
+
+    void close()
+    {
+      running_.store(false);
+      if (thread_.joinable())
+      { thread_.join(); }
+      socket_.reset();
+      context_.reset();
+    }
+
+    bool is_open() const noexcept
+    { return running_.load(); }
+
+    const std::string& address() const noexcept
+    { return address_; }
+
+    void set_handler(channel_kind kind, handler_t handler)
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      handlers_[static_cast<std::size_t>(kind)] = std::move(handler);
+    }
+};
+
+inline return_channel& server_channel()
+{
+  static return_channel channel;
+  return channel;
+}
+
+#endif
@@ -23,21 +23,39 @@ template<typename T>
 inline constexpr bool is_string_v = is_string<T>::value;
 
 /*
-  * Integral and floating point datatypes
+  * Encoding of the payload, tells python side how to decode the buffer.
+  * Containers which are sent as is use "raw"
+*/
+template<typename T>
+inline std::string container_encoding(const T& data)
+{ (void)(data); return "raw"; }
+
+/*
+  * Number of payload frames following the header. Containers made of several buffers (e.g. sparse matrices)
+  * specialize this and implement fill_zmq_buffer(data, frame, buffer) to send each buffer zero-copy as its own frame.
+*/
+template<typename T>
+struct container_frames : std::integral_constant<std::size_t, 1u> {};
+
+template<typename T>
+inline constexpr std::size_t container_frames_v = container_frames<T>::value;
+
+/*
+  * Integral, floating point, complex, half and std::chrono datatypes
 */
 template<typename T>
 inline auto container_size(const T data)
-        -> typename std::enable_if<std::is_arithmetic_v<T>, std::size_t>::type
+        -> typename std::enable_if<is_scalar_v<T>, std::size_t>::type
 { (void)(data); return 1u; }
 
 template<typename T>
 inline auto container_shape(const T data)
-        -> typename std::enable_if<std::is_arithmetic_v<T>, std::array<std::size_t, 1>>::type
+        -> typename std::enable_if<is_scalar_v<T>, std::array<std::size_t, 1>>::type
 { (void)(data); return std::array<std::size_t, 1>{0u}; }
 
 template<typename T>
 inline auto fill_zmq_buffer(const T data, zmq::message_t& buffer)
-        -> typename std::enable_if<std::is_arithmetic_v<T>, void>::type
+        -> typename std::enable_if<is_scalar_v<T>, void>::type
 {
   buffer.rebuild(&data, sizeof(T));
 }
@@ -80,6 +98,32 @@ inline void fill_zmq_buffer(const std::vector<T>& data, zmq::message_t& buffer)
   buffer.rebuild((void*)data.data(), sizeof(T)*data.size(), custom_dealloc, nullptr);
 }
 
+/*
+  * 1D Vector of bool, std::vector<bool> has no contiguous bool buffer 
+  * so pack 8 elements per byte (little bit order, np.unpackbits on python side)
+*/
+inline std::size_t container_size(const std::vector<bool>& data)
+{ return data.size(); }
+
+inline std::array<std::size_t,1> container_shape(const std::vector<bool>& data)
+{ return std::array<std::size_t, 1>{data.size()}; }
+
+inline std::string container_encoding(const std::vector<bool>& data)
+{ (void)(data); return "bits"; }
+
+inline void fill_zmq_buffer(const std::vector<bool>& data, zmq::message_t& buffer)
+{
+  buffer.rebuild((data.size() + 7u)/8u);
+  auto * ptr = static_cast<unsigned char*>(buffer.data());
+  std::memset(ptr, 0, buffer.size());
+
+  for (std::size_t i = 0u; i < data.size(); i++)
+  {
+    if (data[i] == true)
+    { ptr[i >> 3u] |= static_cast<unsigned char>(1u << (i & 7u)); }
+  }
+}
+
 /*
   * 1D Array
 */
@@ -106,7 +150,7 @@ inline std::size_t container_size(const std::vector<std::vector<T>>& data)
 
 template<typename T>
 inline std::array<std::size_t, 2> container_shape(const std::vector<std::vector<T>>& data)
-{ return std::array<std::size_t, 2>{data.size(), data[0].size()}; }
+{ return std::array<std::size_t, 2>{data.size(), data.empty() ? 0u : data[0].size()}; }
 
 // this uses mempcpy, there will be a runtime overhead
 template<typename T>
@@ -175,6 +219,74 @@ inline void fill_zmq_buffer(const Eigen::EigenBase<Derived>& eigen_container, zm
                  custom_dealloc, nullptr);
 }
 
+/*
+  * Eigen sparse matrices, sent as their compressed arrays (outer index, inner index, values), one frame each.
+  * python side gets scipy.sparse csc_matrix (column major) or csr_matrix (row major).
+  * Compressed matrices are sent zero-copy, uncompressed ones (after insert() without makeCompressed()) are compacted into copies.
+*/
+template<typename Scalar, int Options, typename StorageIndex>
+inline std::size_t container_size(const Eigen::SparseMatrix<Scalar, Options, StorageIndex>& data)
+{ return static_cast<std::size_t>(data.nonZeros()); }
+
+template<typename Scalar, int Options, typename StorageIndex>
+inline std::array<std::size_t, 2> container_shape(const Eigen::SparseMatrix<Scalar, Options, StorageIndex>& data)
+{ return std::array<std::size_t, 2>{(std::size_t)data.rows(), (std::size_t)data.cols()}; }
+
+template<typename Scalar, int Options, typename StorageIndex>
+inline std::string container_encoding(const Eigen::SparseMatrix<Scalar, Options, StorageIndex>& data)
+{
+  (void)data;
+  const char index_type[2] = {integral_typestr<StorageIndex>(), '\0'};
+  return std::string((Options & Eigen::RowMajor) ? "sparse:csr," : "sparse:csc,") + index_type;
+}
+
+template<typename Scalar, int Options, typename StorageIndex>
+struct container_frames<Eigen::SparseMatrix<Scalar, Options, StorageIndex>> : std::integral_constant<std::size_t, 3u> {};
+
+template<typename Scalar, int Options, typename StorageIndex>
+void fill_zmq_buffer(const Eigen::SparseMatrix<Scalar, Options, StorageIndex>& data, std::size_t frame, zmq::message_t& buffer)
+{
+  const std::size_t outer_size = static_cast<std::size_t>(data.outerSize());
+  const std::size_t nnz        = static_cast<std::size_t>(data.nonZeros());
+  if (data.isCompressed())
+  {
+    if (frame == 0u)
+    { buffer.rebuild((void*)data.outerIndexPtr(), sizeof(StorageIndex)*(outer_size + 1u), custom_dealloc, nullptr); }
+    else if (nnz == 0u)
+    { buffer.rebuild(0u); }
+    else if (frame == 1u)
+    { buffer.rebuild((void*)data.innerIndexPtr(), sizeof(StorageIndex)*nnz, custom_dealloc, nullptr); }
+    else
+    { buffer.rebuild((void*)data.valuePtr(), sizeof(Scalar)*nnz, custom_dealloc, nullptr); }
+    return;
+  }
+
+  // uncompressed: every outer vector j holds innerNonZeroPtr()[j] entries starting at outerIndexPtr()[j]
+  const StorageIndex* starts = data.outerIndexPtr();
+  const StorageIndex* counts = data.innerNonZeroPtr();
+  if (frame == 0u)
+  {
+    buffer.rebuild(sizeof(StorageIndex)*(outer_size + 1u));
+    auto * offsets = static_cast<StorageIndex*>(buffer.data());
+    offsets[0] = 0;
+    for (std::size_t j = 0u; j < outer_size; j++)
+    { offsets[j + 1u] = offsets[j] + counts[j]; }
+    return;
+  }
+
+  const std::size_t elem_size = (frame == 1u) ? sizeof(StorageIndex) : sizeof(Scalar);
+  const char* src = (frame == 1u) ? reinterpret_cast<const char*>(data.innerIndexPtr()) 
+                                  : reinterpret_cast<const char*>(data.valuePtr());
+  buffer.rebuild(elem_size*nnz);
+  char * ptr = static_cast<char*>(buffer.data());
+  for (std::size_t j = 0u; j < outer_size; j++)
+  {
+    const std::size_t n_bytes = elem_size*static_cast<std::size_t>(counts[j]);
+    std::memcpy(ptr, src + elem_size*static_cast<std::size_t>(starts[j]), n_bytes);
+    ptr += n_bytes;
+  }
+}
+
 #endif
 
 #endif
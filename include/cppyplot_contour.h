@@ -0,0 +1,277 @@
+#ifndef _CPPYPLOT_CONTOUR_H_
+#define _CPPYPLOT_CONTOUR_H_
+
+/*
+  * Iso-lines of 2D scalar fields extracted on C++ side (marching squares), so the field itself is never sent
+  * Cells are classified in parallel row bands, saddle cells are resolved with the mean of their corners and
+  * cells with a non finite corner are skipped. Segments are stitched into polylines through the grid edges they share,
+  * closed lines repeat their first point at the end.
+  * x is the column and y the row coordinate like plt.contour(z), 'extent' (x0, x1, y0, y1) maps them
+  * like plt.contour(z, extent=...) does. n_levels picks evenly spaced levels strictly between min and max.
+  * frames: levels (float64) | first line of every level (uint64, n_levels + 1) |
+  *         first point of every line (uint64, n_lines + 1) | points (float64, n_points x 2)
+  * Python side gets IsoLines, plot() draws one LineCollection per level.
+*/
+struct contour_lines{
+  std::vector<double>        levels;
+  std::vector<std::uint64_t> level_offsets;
+  std::vector<std::uint64_t> line_offsets;
+  std::vector<double>        points;
+};
+
+template<typename T>
+struct contoured{
+  using value_type = double;
+  const T&              data;
+  std::vector<double>   levels;
+  std::size_t           n_levels;
+  std::array<double, 4> extent;
+  // lines are extracted once, header (shape) and payload frames are created from the same result
+  mutable std::shared_ptr<contour_lines> lines;
+};
+
+template<typename T>
+inline auto _contour(std::pair<std::string, T&>&& arg, const std::vector<double>& levels,
+                     const std::array<double, 4>& extent = {AUTO_RANGE, AUTO_RANGE, AUTO_RANGE, AUTO_RANGE})
+{ return std::make_pair(arg.first, contoured<T>{arg.second, levels, levels.size(), extent, nullptr}); }
+
+template<typename T>
+inline auto _contour(std::pair<std::string, T&>&& arg, std::size_t n_levels = 7u,
+                     const std::array<double, 4>& extent = {AUTO_RANGE, AUTO_RANGE, AUTO_RANGE, AUTO_RANGE})
+{ return std::make_pair(arg.first, contoured<T>{arg.second, {}, n_levels, extent, nullptr}); }
+
+/*
+  * Polylines of one level
+  * Crossing points live on grid edges, horizontal edge (r, c) joins (r, c) and (r, c+1) and has id r*cols + c,
+  * vertical edge (r, c) joins (r, c) and (r+1, c) and has id rows*cols + r*cols + c. Every edge is crossed at most once
+  * and shared by at most two cells, so linking segments through their edge ids gives chains without branches.
+  * Row bands are classified in parallel if 'split_rows' is set, otherwise on the calling thread.
+*/
+template<typename T>
+void contour_level(const T& data, double level, std::vector<std::uint64_t>& line_offsets, std::vector<double>& points,
+                   bool split_rows = true)
+{
+  const std::size_t rows = sample_count(data);
+  const std::size_t cols = sample_dims(data);
+  const std::uint64_t n_horizontal = static_cast<std::uint64_t>(rows)*cols;
+  if ((rows < 2u) || (cols < 2u))
+  { return; }
+
+  // segments (pairs of edge ids) per row band, merged in band order
+  std::map<std::size_t, std::vector<std::array<std::uint64_t, 2>>> bands;
+  std::mutex bands_lock;
+  parallel_for(0u, rows - 1u, [&](std::size_t begin, std::size_t end)
+  {
+    std::vector<std::array<std::uint64_t, 2>> local;
+    for (std::size_t r = begin; r < end; r++)
+    {
+      for (std::size_t c = 0u; c + 1u < cols; c++)
+      {
+        // corners clockwise from (r, c)
+        const double v[4] = {sample_at(data, r, c), sample_at(data, r, c + 1u), sample_at(data, r + 1u, c + 1u), sample_at(data, r + 1u, c)};
+        if (((v[0] - v[0]) != 0.0) || ((v[1] - v[1]) != 0.0) || ((v[2] - v[2]) != 0.0) || ((v[3] - v[3]) != 0.0))
+        { continue; }
+
+        const unsigned int above = (v[0] > level ? 1u : 0u) | (v[1] > level ? 2u : 0u) | (v[2] > level ? 4u : 0u) | (v[3] > level ? 8u : 0u);
+        if ((above == 0u) || (above == 15u))
+        { continue; }
+
+        const std::uint64_t top    = static_cast<std::uint64_t>(r)*cols + c;
+        const std::uint64_t bottom = top + cols;
+        const std::uint64_t left   = n_horizontal + top;
+        const std::uint64_t right  = left + 1u;
+        if ((above == 5u) || (above == 10u))
+        {
+          // saddle, the center decides whether corners 0 and 2 are connected
+          const bool center_above = 0.25*(v[0] + v[1] + v[2] + v[3]) > level;
+          if (center_above == ((above & 1u) != 0u))
+          {
+            local.push_back({top, right});
+            local.push_back({bottom, left});
+          }
+          else
+          {
+            local.push_back({left, top});
+            local.push_back({right, bottom});
+          }
+          continue;
+        }
+
+        std::array<std::uint64_t, 2> segment{};
+        std::size_t n_crossed = 0u;
+        const bool b0 = (above & 1u) != 0u, b1 = (above & 2u) != 0u, b2 = (above & 4u) != 0u, b3 = (above & 8u) != 0u;
+        if (b0 != b1) { segment[n_crossed++] = top; }
+        if (b1 != b2) { segment[n_crossed++] = right; }
+        if (b2 != b3) { segment[n_crossed++] = bottom; }
+        if (b3 != b0) { segment[n_crossed++] = left; }
+        local.push_back(segment);
+      }
+    }
+    std::lock_guard<std::mutex> lock(bands_lock);
+    bands.emplace(begin, std::move(local));
+  }, split_rows ? 16u : rows);
+
+  std::vector<std::array<std::uint64_t, 2>> segments;
+  for (auto& [begin, band] : bands)
+  {
+    (void)begin;
+    segments.insert(segments.end(), band.begin(), band.end());
+  }
+
+  // partner[2*s + e]: segment end sharing the edge of end e of segment s, or none
+  constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+  std::vector<std::pair<std::uint64_t, std::size_t>> ends(2u*segments.size());
+  for (std::size_t s = 0u; s < segments.size(); s++)
+  {
+    ends[2u*s]      = std::make_pair(segments[s][0], 2u*s);
+    ends[2u*s + 1u] = std::make_pair(segments[s][1], 2u*s + 1u);
+  }
+  std::sort(ends.begin(), ends.end());
+  std::vector<std::size_t> partner(ends.size(), none);
+  for (std::size_t i = 0u; i + 1u < ends.size(); i++)
+  {
+    if (ends[i].first == ends[i + 1u].first)
+    {
+      partner[ends[i].second]      = ends[i + 1u].second;
+      partner[ends[i + 1u].second] = ends[i].second;
+    }
+  }
+
+  auto add_point = [&](std::uint64_t edge)
+  {
+    const bool vertical = edge >= n_horizontal;
+    const std::uint64_t cell = vertical ? (edge - n_horizontal) : edge;
+    const std::size_t r = static_cast<std::size_t>(cell/cols), c = static_cast<std::size_t>(cell%cols);
+    const double from = sample_at(data, r, c);
+    const double to   = vertical ? sample_at(data, r + 1u, c) : sample_at(data, r, c + 1u);
+    const double t    = (level - from)/(to - from);
+    points.push_back(static_cast<double>(c) + (vertical ? 0.0 : t));
+    points.push_back(static_cast<double>(r) + (vertical ? t : 0.0));
+  };
+
+  // open lines start at an end without partner, what is left afterwards are closed loops
+  std::vector<bool> visited(segments.size(), false);
+  auto trace = [&](std::size_t start_end)
+  {
+    std::size_t end_id = start_end;
+    add_point(segments[end_id/2u][end_id%2u]);
+    while (!visited[end_id/2u])
+    {
+      visited[end_id/2u] = true;
+      const std::size_t exit_end = end_id ^ 1u;
+      add_point(segments[exit_end/2u][exit_end%2u]);
+      end_id = partner[exit_end];
+      if (end_id == none)
+      { break; }
+    }
+    line_offsets.push_back(points.size()/2u);
+  };
+  for (std::size_t e = 0u; e < ends.size(); e++)
+  {
+    if ((partner[e] == none) && !visited[e/2u])
+    { trace(e); }
+  }
+  for (std::size_t s = 0u; s < segments.size(); s++)
+  {
+    if (!visited[s])
+    { trace(2u*s); }
+  }
+}
+
+template<typename T>
+const contour_lines& extracted_lines(const contoured<T>& data)
+{
+  if (data.lines)
+  { return *data.lines; }
+
+  auto lines = std::make_shared<contour_lines>();
+  const std::size_t rows = sample_count(data.data);
+  const std::size_t cols = sample_dims(data.data);
+
+  lines->levels = data.levels;
+  if (lines->levels.empty() && (data.n_levels > 0u))
+  {
+    double min_val = std::numeric_limits<double>::infinity();
+    double max_val = -min_val;
+    for (std::size_t c = 0u; c < cols; c++)
+    {
+      const auto [col_min, col_max] = sample_min_max(data.data, c);
+      min_val = std::min(min_val, col_min);
+      max_val = std::max(max_val, col_max);
+    }
+    for (std::size_t l = 1u; l <= data.n_levels; l++)
+    { lines->levels.push_back(min_val + (max_val - min_val)*static_cast<double>(l)/static_cast<double>(data.n_levels + 1u)); }
+  }
+
+  // only one of the two loops runs in parallel (no threads spawned from worker threads): 
+  // levels when there are enough of them to keep every thread busy, the row bands of every level otherwise
+  const std::size_t n_levels = lines->levels.size();
+  const bool split_levels = (n_levels >= parallel_threads());
+  std::vector<std::vector<std::uint64_t>> level_lines(n_levels);
+  std::vector<std::vector<double>> level_points(n_levels);
+  parallel_for(0u, n_levels, [&](std::size_t begin, std::size_t end)
+  {
+    for (std::size_t l = begin; l < end; l++)
+    { contour_level(data.data, lines->levels[l], level_lines[l], level_points[l], !split_levels); }
+  }, split_levels ? 1u : std::max<std::size_t>(n_levels, 1u));
+
+  // grid coordinates to extent, first/last column at x0/x1 and first/last row at y0/y1
+  const bool has_extent = !(std::isnan(data.extent[0]) || std::isnan(data.extent[1]) || std::isnan(data.extent[2]) || std::isnan(data.extent[3]));
+  const double x_scale  = (has_extent && (cols > 1u)) ? (data.extent[1] - data.extent[0])/static_cast<double>(cols - 1u) : 1.0;
+  const double y_scale  = (has_extent && (rows > 1u)) ? (data.extent[3] - data.extent[2])/static_cast<double>(rows - 1u) : 1.0;
+  const double x_offset = has_extent ? data.extent[0] : 0.0;
+  const double y_offset = has_extent ? data.extent[2] : 0.0;
+
+  lines->level_offsets.push_back(0u);
+  lines->line_offsets.push_back(0u);
+  for (std::size_t l = 0u; l < n_levels; l++)
+  {
+    const std::uint64_t point_base = lines->points.size()/2u;
+    for (const auto offset : level_lines[l])
+    { lines->line_offsets.push_back(point_base + offset); }
+    lines->level_offsets.push_back(lines->line_offsets.size() - 1u);
+
+    for (std::size_t p = 0u; p < level_points[l].size(); p += 2u)
+    {
+      lines->points.push_back(x_offset + x_scale*level_points[l][p]);
+      lines->points.push_back(y_offset + y_scale*level_points[l][p + 1u]);
+    }
+  }
+
+  data.lines = std::move(lines);
+  return *data.lines;
+}
+
+template<typename T>
+inline std::size_t container_size(const contoured<T>& data)
+{ return extracted_lines(data).points.size(); }
+
+template<typename T>
+inline std::array<std::size_t, 2> container_shape(const contoured<T>& data)
+{ return std::array<std::size_t, 2>{extracted_lines(data).points.size()/2u, 2u}; }
+
+template<typename T>
+inline std::string container_encoding(const contoured<T>& data)
+{ return "contour:" + std::to_string(extracted_lines(data).levels.size()); }
+
+template<typename T>
+struct container_frames<contoured<T>> : std::integral_constant<std::size_t, 4u> {};
+
+template<typename T>
+void fill_zmq_buffer(const contoured<T>& data, std::size_t frame, zmq::message_t& buffer)
+{
+  const auto& lines = extracted_lines(data);
+  const void* src = (frame == 0u) ? static_cast<const void*>(lines.levels.data()) :
+                    (frame == 1u) ? static_cast<const void*>(lines.level_offsets.data()) :
+                    (frame == 2u) ? static_cast<const void*>(lines.line_offsets.data()) :
+                                    static_cast<const void*>(lines.points.data());
+  const std::size_t n_bytes = (frame == 0u) ? lines.levels.size()*sizeof(double) :
+                              (frame == 1u) ? lines.level_offsets.size()*sizeof(std::uint64_t) :
+                              (frame == 2u) ? lines.line_offsets.size()*sizeof(std::uint64_t) :
+                                              lines.points.size()*sizeof(double);
+  buffer.rebuild(n_bytes);
+  if (n_bytes > 0u)
+  { std::memcpy(buffer.data(), src, n_bytes); }
+}
+
+#endif
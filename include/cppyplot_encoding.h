@@ -0,0 +1,354 @@
+#ifndef _CPPYPLOT_ENCODING_H_
+#define _CPPYPLOT_ENCODING_H_
+
+/*
+  * Implicit axis (arange) encoding
+  * 1D containers holding an exact arithmetic progression (iota, fixed step linspace, constants)
+  * are sent as (start, step) and rebuilt on python side as start + step*np.arange(n)
+*/
+template<typename T>
+struct is_arange_elem : std::bool_constant<    std::is_arithmetic_v<T>
+                                            && !std::is_same_v<T, bool>
+                                            && !std::is_same_v<T, char>> {};
+
+template<typename T>
+struct is_arange_candidate : std::false_type {};
+
+template<typename T>
+struct is_arange_candidate<std::vector<T>> : is_arange_elem<T> {};
+
+template<typename T, std::size_t N>
+struct is_arange_candidate<std::array<T, N>> : is_arange_elem<T> {};
+
+template<typename T>
+inline constexpr bool is_arange_candidate_v = is_arange_candidate<T>::value;
+
+// elements are compared in blocks without early exit so that the compare loop gets vectorized
+constexpr std::size_t ARANGE_BLOCK = 1024u;
+
+// number of significant mantissa bits of a double
+inline int significant_bits(double value)
+{
+  if (value == 0.0) { return 0; }
+  int exponent;
+  double mantissa = std::frexp(std::fabs(value), &exponent);
+  std::uint64_t bits = static_cast<std::uint64_t>(std::ldexp(mantissa, 53));
+  int n_bits = 53;
+  while ((bits & 1u) == 0u) { bits >>= 1u; n_bits--; }
+  return n_bits;
+}
+
+/* 
+  * integral progressions are checked (and rebuilt) with int64 arithmetic, 
+  * wrap around on overflow matches numpy 
+*/
+template<typename T>
+bool is_arange(const T* data, std::size_t n, std::int64_t& start, std::int64_t& step)
+{
+  start = static_cast<std::int64_t>(data[0]);
+  step  = static_cast<std::int64_t>(static_cast<std::uint64_t>(data[1]) - static_cast<std::uint64_t>(data[0]));
+
+  const std::uint64_t ustart = static_cast<std::uint64_t>(start);
+  const std::uint64_t ustep  = static_cast<std::uint64_t>(step);
+  for (std::size_t block = 0u; block < n; block += ARANGE_BLOCK)
+  {
+    const std::size_t block_end = std::min(n, block + ARANGE_BLOCK);
+    bool matches = true;
+    for (std::size_t i = block; i < block_end; i++)
+    { matches &= (static_cast<T>(ustart + ustep*static_cast<std::uint64_t>(i)) == data[i]); }
+    
+    if (!matches) { return false; }
+  }
+  return true;
+}
+
+/*
+  * floating point progressions are checked against start + step*i evaluated in double. 
+  * step*i has to be exact so that the result does not depend on FMA contraction, 
+  * this holds for the usual float steps and for double steps with a short mantissa (1.0, 0.5, 0.25, ...).
+  * values are compared bitwise (sign of zero included) so the rebuilt array is identical to the container
+*/
+template<typename T>
+bool is_arange(const T* data, std::size_t n, double& start, double& step)
+{
+  start = static_cast<double>(data[0]);
+  step  = static_cast<double>(data[1]) - start;
+  if (!std::isfinite(start) || !std::isfinite(step))
+  { return false; }
+
+  int index_bits = 0;
+  for (std::size_t i = n; i > 0u; i >>= 1u) { index_bits++; }
+  if ((significant_bits(step) + index_bits) > 53)
+  { return false; }
+
+  for (std::size_t block = 0u; block < n; block += ARANGE_BLOCK)
+  {
+    const std::size_t block_end = std::min(n, block + ARANGE_BLOCK);
+    bool matches = true;
+    for (std::size_t i = block; i < block_end; i++)
+    {
+      // == alone accepts -0.0 where the rebuilt value is +0.0
+      const T expected = static_cast<T>(start + step*static_cast<double>(i));
+      matches &= (expected == data[i]) & (std::signbit(expected) == std::signbit(data[i]));
+    }
+
+    if (!matches) { return false; }
+  }
+  return true;
+}
+
+/* 
+  * fills buffer with (start, step) if container is an arithmetic progression, 
+  * containers which are not worth compressing (<= 2 elements) are rejected
+*/
+template<typename T>
+bool fill_arange_buffer(const T& data, zmq::message_t& buffer)
+{
+  using elem_t = typename T::value_type;
+  using axis_t = std::conditional_t<std::is_integral_v<elem_t>, std::int64_t, double>;
+
+  const std::size_t n = data.size();
+  if (n*sizeof(elem_t) <= 2u*sizeof(axis_t))
+  { return false; }
+
+  std::array<axis_t, 2> start_step;
+  if (!is_arange(data.data(), n, start_step[0], start_step[1]))
+  { return false; }
+
+  buffer.rebuild(start_step.data(), sizeof(start_step));
+  return true;
+}
+
+/*
+  * Gorilla style time series encoding 
+  * Reference: Pelkonen et al., "Gorilla: A Fast, Scalable, In-Memory Time Series Database"
+  * floating point values : XOR with previous value, meaningful bits are stored inside a (leading zeros, length) window
+  * integers, std::chrono  : delta-of-delta in zigzag form, bucketed by width
+  *
+  * Every element gets a 2bit code and codes, windows and bits are kept in separate streams 
+  * so that python side can decode with vectorized numpy routines.
+  * payload: [n, n_windows, n_bits] (uint64) | codes (2bit each) | windows (uint8 pairs of leading zeros, length) | bits
+*/
+template<typename T>
+struct gorilla_encoded{
+  using value_type = typename T::value_type;
+  const T& data;
+};
+
+template<typename T>
+inline auto _gorilla(std::pair<std::string, T&>&& arg)
+{ return std::make_pair(std::move(arg.first), gorilla_encoded<T>{arg.second}); }
+
+// bit width of each delta-of-delta code (code 0 -> unchanged delta)
+constexpr std::array<unsigned int, 4> GORILLA_DOD_BITS{0u, 8u, 24u, 64u};
+
+// a new XOR window costs 16bits, reuse the previous one unless it wastes more than that
+constexpr unsigned int GORILLA_WINDOW_SLACK = 16u;
+
+inline unsigned int leading_zeros(std::uint64_t value)
+{
+#if defined(_MSC_VER)
+  unsigned long idx;
+  return _BitScanReverse64(&idx, value) ? 63u - idx : 64u;
+#else
+  return (value == 0u) ? 64u : static_cast<unsigned int>(__builtin_clzll(value));
+#endif
+}
+
+inline unsigned int trailing_zeros(std::uint64_t value)
+{
+#if defined(_MSC_VER)
+  unsigned long idx;
+  return _BitScanForward64(&idx, value) ? idx : 64u;
+#else
+  return (value == 0u) ? 64u : static_cast<unsigned int>(__builtin_ctzll(value));
+#endif
+}
+
+/* MSB first bit stream, same bit order as np.packbits */
+class bit_writer{
+  private:
+    std::vector<unsigned char> bytes_;
+    std::uint64_t acc_    = 0u;
+    unsigned int  filled_ = 0u;
+    std::size_t   n_bits_ = 0u;
+
+    void flush_acc()
+    {
+      for (int shift = 56; shift >= 0; shift -= 8)
+      { bytes_.push_back(static_cast<unsigned char>(acc_ >> shift)); }
+      acc_    = 0u;
+      filled_ = 0u;
+    }
+  public:
+    void reserve(std::size_t n_bytes)
+    { bytes_.reserve(n_bytes); }
+
+    // writes lower n_bits (<= 64) of value
+    void write(std::uint64_t value, unsigned int n_bits)
+    {
+      n_bits_ += n_bits;
+      while (n_bits > 0u)
+      {
+        const unsigned int take = std::min(64u - filled_, n_bits);
+        const std::uint64_t mask = (take == 64u) ? ~std::uint64_t{0u} : ((std::uint64_t{1u} << take) - 1u);
+        const std::uint64_t chunk = (value >> (n_bits - take)) & mask;
+
+        acc_     = (take == 64u) ? chunk : ((acc_ << take) | chunk);
+        filled_ += take;
+        n_bits  -= take;
+        if (filled_ == 64u) { flush_acc(); }
+      }
+    }
+
+    const std::vector<unsigned char>& finish()
+    {
+      if (filled_ > 0u)
+      {
+        const unsigned int n_bytes = (filled_ + 7u)/8u;
+        acc_ <<= (64u - filled_);
+        for (unsigned int i = 0u; i < n_bytes; i++)
+        { bytes_.push_back(static_cast<unsigned char>(acc_ >> (56u - 8u*i))); }
+        acc_    = 0u;
+        filled_ = 0u;
+      }
+      return bytes_;
+    }
+
+    std::size_t n_bits() const noexcept
+    { return n_bits_; }
+};
+
+template<typename T>
+inline std::int64_t to_ticks(const T& elem)
+{
+  if constexpr (is_duration<T>::value)
+  { return static_cast<std::int64_t>(elem.count()); }
+  else if constexpr (is_time_point<T>::value)
+  { return static_cast<std::int64_t>(elem.time_since_epoch().count()); }
+  else
+  { return static_cast<std::int64_t>(elem); }
+}
+
+template<typename T>
+inline std::uint64_t to_word(const T elem)
+{
+  if constexpr (sizeof(T) == 4u)
+  {
+    std::uint32_t word;
+    std::memcpy(&word, &elem, sizeof(word));
+    return word;
+  }
+  else
+  {
+    std::uint64_t word;
+    std::memcpy(&word, &elem, sizeof(word));
+    return word;
+  }
+}
+
+template<typename T>
+inline std::size_t container_size(const gorilla_encoded<T>& data)
+{ return container_size(data.data); }
+
+template<typename T>
+inline auto container_shape(const gorilla_encoded<T>& data)
+{ return container_shape(data.data); }
+
+template<typename T>
+inline std::string container_encoding(const gorilla_encoded<T>& data)
+{ (void)(data); return "gorilla"; }
+
+template<typename T>
+void fill_zmq_buffer(const gorilla_encoded<T>& data, zmq::message_t& buffer)
+{
+  using elem_t = typename T::value_type;
+  static_assert(   (std::is_floating_point_v<elem_t> && (sizeof(elem_t) == 4u || sizeof(elem_t) == 8u))
+                || std::is_integral_v<elem_t> || is_duration<elem_t>::value || is_time_point<elem_t>::value, 
+                "gorilla encoding supports float, double, integers and std::chrono types");
+
+  const std::size_t n = data.data.size();
+  std::vector<unsigned char> codes((2u*n + 7u)/8u, 0u);
+  std::vector<unsigned char> windows;
+  bit_writer bits;
+  bits.reserve(n);
+
+  auto set_code = [&codes](std::size_t i, unsigned int code)
+  { codes[i >> 2u] |= static_cast<unsigned char>(code << (6u - 2u*(i & 3u))); };
+
+  if constexpr (std::is_floating_point_v<elem_t>)
+  {
+    std::uint64_t prev = 0u;
+    unsigned int win_lz = 0u, win_len = 0u;
+    bool has_window = false;
+    for (std::size_t i = 0u; i < n; i++)
+    {
+      const std::uint64_t word  = to_word(data.data[i]);
+      const std::uint64_t delta = word ^ prev;
+      prev = word;
+      if (delta == 0u)
+      { continue; }
+
+      const unsigned int lz  = leading_zeros(delta);
+      const unsigned int tz  = trailing_zeros(delta);
+      const unsigned int len = 64u - lz - tz;
+      if (   has_window && (lz >= win_lz) && (tz >= (64u - win_lz - win_len))
+          && ((win_len - len) <= GORILLA_WINDOW_SLACK))
+      {
+        set_code(i, 1u);
+        bits.write(delta >> (64u - win_lz - win_len), win_len);
+      }
+      else
+      {
+        set_code(i, 2u);
+        windows.push_back(static_cast<unsigned char>(lz));
+        windows.push_back(static_cast<unsigned char>(len));
+        bits.write(delta >> tz, len);
+        win_lz     = lz;
+        win_len    = len;
+        has_window = true;
+      }
+    }
+  }
+  else
+  {
+    std::uint64_t prev = 0u, prev_delta = 0u;
+    for (std::size_t i = 0u; i < n; i++)
+    {
+      const std::uint64_t ticks = static_cast<std::uint64_t>(to_ticks(data.data[i]));
+      const std::uint64_t delta = ticks - prev;
+      const std::int64_t  dod   = static_cast<std::int64_t>(delta - prev_delta);
+      const std::uint64_t zz    = (static_cast<std::uint64_t>(dod) << 1u) ^ static_cast<std::uint64_t>(dod >> 63);
+      prev       = ticks;
+      prev_delta = delta;
+
+      unsigned int code = 0u;
+      while ((code < 3u) && (zz >> GORILLA_DOD_BITS[code]) != 0u)
+      { code++; }
+      
+      if (code > 0u)
+      {
+        set_code(i, code);
+        bits.write(zz, GORILLA_DOD_BITS[code]);
+      }
+    }
+  }
+
+  const std::size_t n_bits = bits.n_bits();
+  const std::vector<unsigned char>& bit_stream = bits.finish();
+  const std::array<std::uint64_t, 3> info{n, windows.size()/2u, n_bits};
+
+  buffer.rebuild(sizeof(info) + codes.size() + windows.size() + bit_stream.size());
+  char * ptr = static_cast<char*>(buffer.data());
+  std::memcpy(ptr, info.data(), sizeof(info));
+  ptr += sizeof(info);
+  std::memcpy(ptr, codes.data(), codes.size());
+  ptr += codes.size();
+  if (!windows.empty())
+  { std::memcpy(ptr, windows.data(), windows.size()); }
+  ptr += windows.size();
+  if (!bit_stream.empty())
+  { std::memcpy(ptr, bit_stream.data(), bit_stream.size()); }
+}
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef _CPPYPLOT_EVENTS_H_
+#define _CPPYPLOT_EVENTS_H_
+
+/*
+  * GUI events from the plot window back to C++ (interactive tuning panels).
+  * In a plot script events.connect(fig) forwards the clicks, key presses, scrolls and picks of a figure,
+  * events.widget(slider, "gain") the value changes of a matplotlib widget (Slider, RangeSlider, CheckButtons,
+  * RadioButtons, TextBox, Button). Every event is one fixed size plot_event message on the return channel,
+  * it is handed to the callbacks registered with pyp.on_event() on the receiving thread right away and queued
+  * into a lock-free ring of EVENT_QUEUE_SIZE events read with cppyplot::poll_event(), events that find the ring full are dropped.
+  * Python side runs the GUI event loop while it waits for plot calls, so events are delivered between plot calls too.
+*/
+constexpr std::size_t EVENT_QUEUE_SIZE = 1024u;
+
+enum class event_type : std::uint32_t { click = 0u, release = 1u, key = 2u, scroll = 3u, pick = 4u, widget = 5u };
+
+struct plot_event{
+  event_type    type;
+  std::uint32_t figure;     // figure number
+  std::int32_t  axes;       // index into figure.axes, -1 outside of any axes (and for widgets)
+  std::int32_t  button;     // mouse button (1 left, 2 middle, 3 right), scroll steps (+up, -down)
+  std::int64_t  index;      // first picked index, selected option (RadioButtons, CheckButtons) or -1
+  double        x;          // data coordinates of the mouse, NaN outside of axes. RangeSlider: low, high
+  double        y;
+  double        value;      // widget value (Slider, CheckButtons state, RadioButtons index, TextBox number or NaN)
+  char          name[24];   // key ("a", "ctrl+s", "left"), widget name or label of the picked artist, nul terminated
+
+  std::string_view text() const noexcept
+  { return std::string_view(name, static_cast<std::size_t>(std::find(name, name + sizeof(name), '\0') - name)); }
+};
+static_assert(sizeof(plot_event) == 72u, "plot_event has to match the python struct '<IIiiqddd24s'");
+
+class event_dispatcher{
+  private:
+    using callback_t = std::function<void(const plot_event&)>;
+
+    // single producer (return channel thread), single consumer ring
+    std::vector<plot_event>    ring_ = std::vector<plot_event>(EVENT_QUEUE_SIZE);
+    std::atomic<std::uint64_t> head_{0u};
+    std::atomic<std::uint64_t> tail_{0u};
+    std::atomic<std::uint64_t> dropped_{0u};
+
+    std::mutex                                     lock_;   // guards callbacks_
+    std::vector<std::pair<std::string, callback_t>> callbacks_;
+
+    void dispatch(const plot_event& event)
+    {
+      {
+        std::lock_guard<std::mutex> lock(lock_);
+        for (const auto& [name, callback] : callbacks_)
+        {
+          if (name.empty() || (name == event.text()))
+          { callback(event); }
+        }
+      }
+
+      const std::uint64_t head = head_.load(std::memory_order_relaxed);
+      if ((head - tail_.load(std::memory_order_acquire)) < EVENT_QUEUE_SIZE)
+      {
+        ring_[static_cast<std::size_t>(head % EVENT_QUEUE_SIZE)] = event;
+        head_.store(head + 1u, std::memory_order_release);
+      }
+      else
+      { dropped_.fetch_add(1u, std::memory_order_relaxed); }
+    }
+
+  public:
+    // receives events over the return channel (opened at 'address' unless already open)
+    bool enable(const std::string& address)
+    {
+      if (!server_channel().open(address))
+      { return false; }
+      server_channel().set_handler(channel_kind::event, [this](const char* data, std::size_t size)
+      {
+        if (size != sizeof(plot_event))
+        { return; }
+        plot_event event;
+        std::memcpy(&event, data, sizeof(event));
+        event.name[sizeof(event.name) - 1u] = '\0';
+        dispatch(event);
+      });
+      return true;
+    }
+
+    // callback for every event (empty name) or for the events of one widget, key or picked artist
+    void add_callback(const std::string& name, callback_t callback)
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      callbacks_.emplace_back(name, std::move(callback));
+    }
+
+    void clear_callbacks()
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      callbacks_.clear();
+    }
+
+    // oldest queued event, single consumer
+    bool poll(plot_event& event) noexcept
+    {
+      const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+      if (tail == head_.load(std::memory_order_acquire))
+      { return false; }
+      event = ring_[static_cast<std::size_t>(tail % EVENT_QUEUE_SIZE)];
+      tail_.store(tail + 1u, std::memory_order_release);
+      return true;
+    }
+
+    std::uint64_t dropped() const noexcept
+    { return dropped_.load(std::memory_order_relaxed); }
+};
+
+inline event_dispatcher& plot_events()
+{
+  static event_dispatcher dispatcher;
+  return dispatcher;
+}
+
+#endif
@@ -0,0 +1,335 @@
+#ifndef _CPPYPLOT_FIDELITY_H_
+#define _CPPYPLOT_FIDELITY_H_
+
+/*
+  * Adaptive fidelity driven by server backpressure. With cppyplot::set_adaptive() the server publishes its backlog
+  * (plot calls received but not evaluated, queued frames) and the mean eval time of a plot call over the return channel.
+  * The level rises by one while FIDELITY_LAG_CALLS or more calls wait (at most every FIDELITY_STEP_INTERVAL) and falls
+  * by one after FIDELITY_RESTORE_DELAY without backlog. At level L (0 = full fidelity, decimation d = 2^L)
+  *   _adaptive containers keep every d-th row, as float32 from level 2 and float16 at level 3 (floating point only)
+  *   _point_budget and _downscale budgets are divided by d
+  *   calls with containers are sent at most every 2^(L-1) server eval times, the others are skipped
+  *   (calls without containers, figure setup, are always sent)
+  *   the watch sampler flushes d times less often
+  * The level is taken once per message so that every container of a call is decimated alike.
+  * cppyplot::fidelity_stats() returns the current level and the last server status.
+  * status: pending calls, queued frames, evaluated calls (uint64) | mean eval time (float64 s)
+*/
+constexpr std::size_t               FIDELITY_LEVELS    = 4u;
+constexpr std::uint64_t             FIDELITY_LAG_CALLS = 3u;
+constexpr std::chrono::milliseconds FIDELITY_STEP_INTERVAL{250};
+constexpr std::chrono::milliseconds FIDELITY_RESTORE_DELAY{1000};
+
+struct fidelity_state{
+  std::size_t   level;           // 0 full fidelity ... FIDELITY_LEVELS - 1
+  std::size_t   decimation;      // 2^level
+  double        min_interval;    // s between calls with containers, 0 without limit
+  std::uint64_t calls_sent;
+  std::uint64_t calls_skipped;   // by the rate limit
+  bool          connected;       // a server status was received
+  std::uint64_t server_pending;  // plot calls waiting on the server
+  std::uint64_t server_queued;   // frames waiting on the server
+  std::uint64_t server_done;     // plot calls evaluated by the server
+  double        server_eval;     // s per plot call (moving average)
+};
+
+class fidelity_controller{
+  private:
+    using clock = std::chrono::steady_clock;
+
+    mutable std::mutex               lock_;
+    std::atomic<std::size_t>         level_{0u};
+    std::size_t                      message_level_ = 0u;   // send_lock() held
+    fidelity_state                   state_{};
+    clock::time_point                last_step_;
+    clock::time_point                calm_since_;
+    clock::time_point                last_call_;
+    bool                             calm_ = false;
+    std::atomic<bool>                enabled_{false};
+
+  public:
+    fidelity_controller() = default;
+    fidelity_controller(const fidelity_controller&) = delete;
+    fidelity_controller& operator=(const fidelity_controller&) = delete;
+
+    // receives the server status over the return channel (opened at 'address' unless already open)
+    bool enable(const std::string& address)
+    {
+      if (!server_channel().open(address))
+      { return false; }
+      server_channel().set_handler(channel_kind::status, [this](const char* status, std::size_t size)
+      {
+        if (size != 32u)
+        { return; }
+        std::uint64_t counts[3];
+        double eval_s;
+        std::memcpy(counts, status, sizeof(counts));
+        std::memcpy(&eval_s, status + sizeof(counts), sizeof(eval_s));
+        update(counts[0], counts[1], counts[2], eval_s, clock::now());
+      });
+      enabled_.store(true);
+      return true;
+    }
+
+    void stop()
+    {
+      enabled_.store(false);
+      server_channel().set_handler(channel_kind::status, nullptr);
+    }
+
+    bool enabled() const noexcept
+    { return enabled_.load(); }
+
+    // server status, steps the level
+    void update(std::uint64_t pending, std::uint64_t queued, std::uint64_t done, double eval_s, clock::time_point now)
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      state_.connected      = true;
+      state_.server_pending = pending;
+      state_.server_queued  = queued;
+      state_.server_done    = done;
+      state_.server_eval    = eval_s;
+
+      const std::size_t level = level_.load(std::memory_order_relaxed);
+      if (pending >= FIDELITY_LAG_CALLS)
+      {
+        calm_ = false;
+        if ((level + 1u < FIDELITY_LEVELS) && (now - last_step_ >= FIDELITY_STEP_INTERVAL))
+        {
+          level_.store(level + 1u, std::memory_order_relaxed);
+          last_step_ = now;
+        }
+      }
+      else if (pending == 0u)
+      {
+        if (!calm_)
+        {
+          calm_       = true;
+          calm_since_ = now;
+        }
+        else if ((level > 0u) && (now - calm_since_ >= FIDELITY_RESTORE_DELAY))
+        {
+          level_.store(level - 1u, std::memory_order_relaxed);
+          last_step_  = now;
+          calm_since_ = now;
+        }
+      }
+      else
+      { calm_ = false; }
+    }
+
+    std::size_t level() const noexcept
+    { return level_.load(std::memory_order_relaxed); }
+
+    std::size_t decimation() const noexcept
+    { return std::size_t{1u} << level(); }
+
+    // level used by every container of the message being sent (send_lock() held)
+    void begin_message() noexcept
+    { message_level_ = level(); }
+
+    std::size_t message_level() const noexcept
+    { return message_level_; }
+
+    // rate limit of calls with containers, false if the call has to be skipped
+    bool admit()
+    {
+      const std::size_t current = level();
+      std::lock_guard<std::mutex> lock(lock_);
+      const auto now = clock::now();
+      if ((current > 0u) && (state_.server_eval > 0.0))
+      {
+        const auto interval = std::chrono::duration<double>(state_.server_eval*static_cast<double>(std::size_t{1u} << (current - 1u)));
+        if ((now - last_call_) < interval)
+        {
+          state_.calls_skipped++;
+          return false;
+        }
+      }
+      last_call_ = now;
+      return true;
+    }
+
+    void sent()
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      state_.calls_sent++;
+    }
+
+    fidelity_state state() const
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      fidelity_state state = state_;
+      state.level        = level();
+      state.decimation   = std::size_t{1u} << state.level;
+      state.min_interval = (state.level > 0u) ? state_.server_eval*static_cast<double>(std::size_t{1u} << (state.level - 1u)) : 0.0;
+      return state;
+    }
+};
+
+inline fidelity_controller& fidelity()
+{
+  static fidelity_controller controller;
+  return controller;
+}
+
+/* IEEE half precision bits of 'value', rounded to nearest even */
+inline std::uint16_t half_bits(float value) noexcept
+{
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const std::uint16_t sign     = static_cast<std::uint16_t>((bits >> 16u) & 0x8000u);
+  const std::uint32_t exponent = (bits >> 23u) & 0xFFu;
+  std::uint32_t       mantissa = bits & 0x7FFFFFu;
+  if (exponent == 0xFFu)
+  { return static_cast<std::uint16_t>(sign | 0x7C00u | ((mantissa != 0u) ? 0x200u : 0u)); }
+
+  const int half_exponent = static_cast<int>(exponent) - 127 + 15;
+  if (half_exponent >= 31)
+  { return static_cast<std::uint16_t>(sign | 0x7C00u); }
+
+  std::uint32_t half, rest, halfway;
+  if (half_exponent <= 0)
+  {
+    // subnormal (or zero) half
+    if (half_exponent < -10)
+    { return sign; }
+    mantissa |= 0x800000u;
+    const std::uint32_t shift = static_cast<std::uint32_t>(14 - half_exponent);
+    half    = mantissa >> shift;
+    rest    = mantissa & ((1u << shift) - 1u);
+    halfway = 1u << (shift - 1u);
+  }
+  else
+  {
+    half    = (static_cast<std::uint32_t>(half_exponent) << 10u) | (mantissa >> 13u);
+    rest    = mantissa & 0x1FFFu;
+    halfway = 0x1000u;
+  }
+  // a carry out of the mantissa steps the exponent (up to infinity)
+  if ((rest > halfway) || ((rest == halfway) && ((half & 1u) != 0u)))
+  { half++; }
+  return static_cast<std::uint16_t>(sign | half);
+}
+
+/*
+  * Container sent at the fidelity of the current message: every d-th row (first axis) and reduced floating point
+  * precision under backpressure, unchanged (and zero-copy where the container is) at full fidelity.
+  * payload: kept rows back to back in the dtype given by the encoding "fidelity:<d>,<dtype>"
+*/
+template<typename T>
+struct adaptive{
+  using value_type = typename T::value_type;
+  const T& data;
+};
+
+template<typename T>
+inline auto _adaptive(std::pair<std::string, T&>&& arg)
+{ return std::make_pair(arg.first, adaptive<T>{arg.second}); }
+
+// dtype sent at 'level', only floating point data is reduced
+inline std::string adaptive_dtype(const std::string& dtype, std::size_t level)
+{
+  if ((level >= 3u) && ((dtype == "d") || (dtype == "f")))
+  { return "e"; }
+  if ((level >= 2u) && (dtype == "d"))
+  { return "f"; }
+  return dtype;
+}
+
+template<typename T>
+inline std::vector<std::size_t> container_shape(const adaptive<T>& data)
+{
+  const auto full = container_shape(data.data);
+  std::vector<std::size_t> shape(full.begin(), full.end());
+  const std::size_t decimation = std::size_t{1u} << fidelity().message_level();
+  if (!shape.empty() && (shape[0] > 0u))
+  { shape[0] = (shape[0] + decimation - 1u)/decimation; }
+  return shape;
+}
+
+template<typename T>
+inline std::size_t container_size(const adaptive<T>& data)
+{
+  const std::size_t level = fidelity().message_level();
+  if (level == 0u)
+  { return container_size(data.data); }
+  const auto shape = container_shape(data);
+  return std::accumulate(shape.begin(), shape.end(), std::size_t{1u}, std::multiplies<std::size_t>());
+}
+
+template<typename T>
+inline std::string container_encoding(const adaptive<T>& data)
+{
+  const std::size_t level = fidelity().message_level();
+  if (level == 0u)
+  { return container_encoding(data.data); }
+  return "fidelity:" + std::to_string(std::size_t{1u} << level) + "," + adaptive_dtype(dtype_str(unpack_type<T>()), level);
+}
+
+template<typename T>
+void fill_zmq_buffer(const adaptive<T>& data, zmq::message_t& buffer)
+{
+  static_assert((container_frames_v<T> == 1u) && !std::is_same_v<std::remove_cv_t<T>, std::vector<bool>>,
+                "only containers sent as one raw frame can be adaptive");
+  const std::size_t level = fidelity().message_level();
+  fill_zmq_buffer(data.data, buffer);
+  if (level == 0u)
+  { return; }
+
+  const auto full              = container_shape(data.data);
+  const std::size_t rows       = (full.begin() == full.end()) ? 0u : *full.begin();
+  if (rows == 0u)
+  { return; }
+  const std::size_t decimation = std::size_t{1u} << level;
+  const std::size_t kept       = (rows + decimation - 1u)/decimation;
+  const std::size_t row_bytes  = buffer.size()/rows;
+  const std::string dtype      = dtype_str(unpack_type<T>());
+  const std::string sent       = adaptive_dtype(dtype, level);
+  const char * in              = static_cast<const char*>(buffer.data());
+
+  zmq::message_t reduced;
+  if (sent == dtype)
+  {
+    reduced.rebuild(kept*row_bytes);
+    char * out = static_cast<char*>(reduced.data());
+    for (std::size_t r = 0u; r < kept; r++)
+    { std::memcpy(out + r*row_bytes, in + r*decimation*row_bytes, row_bytes); }
+  }
+  else
+  {
+    const std::size_t in_size  = (dtype == "d") ? sizeof(double) : sizeof(float);
+    const std::size_t row_elems = row_bytes/in_size;
+    const std::size_t out_size = (sent == "f") ? sizeof(float) : sizeof(std::uint16_t);
+    reduced.rebuild(kept*row_elems*out_size);
+    char * out = static_cast<char*>(reduced.data());
+    for (std::size_t r = 0u; r < kept; r++)
+    {
+      const char * row = in + r*decimation*row_bytes;
+      for (std::size_t i = 0u; i < row_elems; i++)
+      {
+        float value;
+        if (in_size == sizeof(double))
+        {
+          double wide;
+          std::memcpy(&wide, row + i*in_size, sizeof(wide));
+          value = static_cast<float>(wide);
+        }
+        else
+        { std::memcpy(&value, row + i*in_size, sizeof(value)); }
+
+        char * dest = out + (r*row_elems + i)*out_size;
+        if (out_size == sizeof(float))
+        { std::memcpy(dest, &value, sizeof(value)); }
+        else
+        {
+          const std::uint16_t half = half_bits(value);
+          std::memcpy(dest, &half, sizeof(half));
+        }
+      }
+    }
+  }
+  buffer = std::move(reduced);
+}
+
+#endif
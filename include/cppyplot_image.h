@@ -0,0 +1,612 @@
+#ifndef _CPPYPLOT_IMAGE_H_
+#define _CPPYPLOT_IMAGE_H_
+
+/* row pointer of 2D containers, rows are assumed to be of equal length */
+template<typename T>
+inline const T* image_row(const std::vector<std::vector<T>>& data, std::size_t row)
+{ return data[row].data(); }
+
+template<typename T, std::size_t N, std::size_t M>
+inline const T* image_row(const std::array<std::array<T, M>, N>& data, std::size_t row)
+{ return data[row].data(); }
+
+#if defined (EIGEN_AVAILABLE)
+/*
+  * rows of row major matrices (and of single columns) are read in place, rows of column major matrices 
+  * are copied into a per thread buffer which is valid until the next image_row call of the same thread
+*/
+template<typename Derived>
+inline const typename Derived::Scalar* image_row(const Eigen::PlainObjectBase<Derived>& data, std::size_t row)
+{
+  const std::size_t cols = static_cast<std::size_t>(data.cols());
+  if (Derived::IsRowMajor || (cols == 1u))
+  { return data.data() + row*cols; }
+
+  thread_local std::vector<typename Derived::Scalar> row_copy;
+  row_copy.resize(cols);
+  for (std::size_t c = 0u; c < cols; c++)
+  { row_copy[c] = data.coeff(static_cast<Eigen::Index>(row), static_cast<Eigen::Index>(c)); }
+  return row_copy.data();
+}
+#endif
+
+template<typename T>
+using image_elem_t = std::remove_cv_t<std::remove_pointer_t<decltype(image_row(std::declval<const T&>(), 0u))>>;
+
+/*
+  * Block-delta (tile) encoding for realtime image streams
+  * Frame is split into tiles and only tiles that changed since the previous frame are sent, 
+  * python side patches the last frame and calls set_data on the AxesImage named 'image_name' (if given).
+  * A full keyframe is sent for the first frame, on shape change and every TILE_KEYFRAME_INTERVAL frames
+  * so that the server recovers from dropped messages.
+  * payload: keyframe: [1, 0] (uint32) | frame
+  *          delta   : [0, n_changed] (uint32) | tile index (uint32 x n_changed) | changed tiles (row major each)
+*/
+constexpr std::size_t TILE_KEYFRAME_INTERVAL = 100u;
+
+template<typename T>
+struct tile_encoded{
+  using value_type = typename T::value_type;
+  const T&    data;
+  std::string key;
+  std::string image_name;
+  std::size_t tile_size;
+};
+
+template<typename T>
+inline auto _tiles(std::pair<std::string, T&>&& arg, const std::string& image_name = "", std::size_t tile_size = 32u)
+{ return std::make_pair(arg.first, tile_encoded<T>{arg.second, arg.first, image_name, tile_size}); }
+
+/* last frame sent for each stream (variable name) */
+struct tile_stream_state{
+  std::vector<char> frame;
+  std::size_t rows      = 0u;
+  std::size_t cols      = 0u;
+  std::size_t elem_size = 0u;
+  std::size_t n_frames  = 0u;
+};
+
+inline tile_stream_state& tile_stream(const std::string& key)
+{
+  static std::map<std::string, tile_stream_state> streams;
+  return streams[key];
+}
+
+template<typename T>
+inline std::size_t container_size(const tile_encoded<T>& data)
+{ return container_size(data.data); }
+
+template<typename T>
+inline auto container_shape(const tile_encoded<T>& data)
+{ return container_shape(data.data); }
+
+template<typename T>
+inline std::string container_encoding(const tile_encoded<T>& data)
+{ return "tiles:" + std::to_string(data.tile_size) + "," + std::to_string(data.tile_size) + "," + data.image_name; }
+
+template<typename T>
+void fill_zmq_buffer(const tile_encoded<T>& data, zmq::message_t& buffer)
+{
+  using elem_t = image_elem_t<T>;
+  const auto [rows, cols]     = container_shape(data.data);
+  const std::size_t row_bytes = cols*sizeof(elem_t);
+  const std::size_t tile      = std::max<std::size_t>(data.tile_size, 1u);
+  tile_stream_state& state    = tile_stream(data.key);
+
+  const bool keyframe =    (state.rows != rows) || (state.cols != cols) || (state.elem_size != sizeof(elem_t))
+                        || ((state.n_frames % TILE_KEYFRAME_INTERVAL) == 0u);
+  state.n_frames++;
+
+  if (keyframe)
+  {
+    state.rows      = rows;
+    state.cols      = cols;
+    state.elem_size = sizeof(elem_t);
+    state.n_frames  = 1u;
+    state.frame.resize(rows*row_bytes);
+    for (std::size_t r = 0u; r < rows; r++)
+    { std::memcpy(state.frame.data() + r*row_bytes, image_row(data.data, r), row_bytes); }
+
+    const std::array<std::uint32_t, 2> info{1u, 0u};
+    buffer.rebuild(sizeof(info) + state.frame.size());
+    std::memcpy(buffer.data(), info.data(), sizeof(info));
+    std::memcpy(static_cast<char*>(buffer.data()) + sizeof(info), state.frame.data(), state.frame.size());
+    return;
+  }
+
+  const std::size_t tiles_per_row = (cols + tile - 1u)/tile;
+  const std::size_t tiles_per_col = (rows + tile - 1u)/tile;
+  std::vector<std::uint32_t> changed;
+  std::vector<char> tile_bytes;
+
+  for (std::size_t tile_r = 0u; tile_r < tiles_per_col; tile_r++)
+  {
+    const std::size_t row_start = tile_r*tile;
+    const std::size_t row_end   = std::min(rows, row_start + tile);
+    for (std::size_t tile_c = 0u; tile_c < tiles_per_row; tile_c++)
+    {
+      const std::size_t col_start  = tile_c*tile;
+      const std::size_t tile_width = (std::min(cols, col_start + tile) - col_start)*sizeof(elem_t);
+      const std::size_t col_offset = col_start*sizeof(elem_t);
+
+      // memcmp is vectorized by the C library
+      bool is_changed = false;
+      for (std::size_t r = row_start; (r < row_end) && !is_changed; r++)
+      {
+        const char* cur = reinterpret_cast<const char*>(image_row(data.data, r)) + col_offset;
+        is_changed = (std::memcmp(state.frame.data() + r*row_bytes + col_offset, cur, tile_width) != 0);
+      }
+      if (!is_changed)
+      { continue; }
+
+      changed.push_back(static_cast<std::uint32_t>(tile_r*tiles_per_row + tile_c));
+      for (std::size_t r = row_start; r < row_end; r++)
+      {
+        const char* cur = reinterpret_cast<const char*>(image_row(data.data, r)) + col_offset;
+        std::memcpy(state.frame.data() + r*row_bytes + col_offset, cur, tile_width);
+        tile_bytes.insert(tile_bytes.end(), cur, cur + tile_width);
+      }
+    }
+  }
+
+  const std::array<std::uint32_t, 2> info{0u, static_cast<std::uint32_t>(changed.size())};
+  const std::size_t idx_bytes = changed.size()*sizeof(std::uint32_t);
+  buffer.rebuild(sizeof(info) + idx_bytes + tile_bytes.size());
+  char * ptr = static_cast<char*>(buffer.data());
+  std::memcpy(ptr, info.data(), sizeof(info));
+  if (!changed.empty())
+  {
+    std::memcpy(ptr + sizeof(info), changed.data(), idx_bytes);
+    std::memcpy(ptr + sizeof(info) + idx_bytes, tile_bytes.data(), tile_bytes.size());
+  }
+}
+
+/*
+  * Colormap applied on C++ side
+  * 2D containers are normalised with (vmin, vmax) and mapped through a baked matplotlib LUT into 
+  * uint8 RGBA (or RGB) frames of shape (rows, cols, 4|3), python side passes them straight to imshow.
+  * vmin/vmax default to the min/max of the finite values, NaN maps to transparent (RGBA) or black (RGB).
+*/
+template<typename T>
+struct colormap_encoded{
+  using value_type = std::uint8_t;
+  const T&    data;
+  cmap        name;
+  double      vmin;
+  double      vmax;
+  std::size_t channels;
+};
+
+template<typename T>
+inline auto _colormap(std::pair<std::string, T&>&& arg, cmap name = cmap::viridis, 
+                      double vmin = std::numeric_limits<double>::quiet_NaN(),
+                      double vmax = std::numeric_limits<double>::quiet_NaN(), 
+                      bool with_alpha = true)
+{ return std::make_pair(arg.first, colormap_encoded<T>{arg.second, name, vmin, vmax, with_alpha ? 4u : 3u}); }
+
+template<typename T>
+inline std::size_t container_size(const colormap_encoded<T>& data)
+{ return container_size(data.data)*data.channels; }
+
+template<typename T>
+inline std::array<std::size_t, 3> container_shape(const colormap_encoded<T>& data)
+{
+  const auto [rows, cols] = container_shape(data.data);
+  return std::array<std::size_t, 3>{rows, cols, data.channels};
+}
+
+template<typename T>
+std::pair<double, double> finite_min_max(const T& data)
+{
+  const auto [rows, cols] = container_shape(data);
+  double min_val = std::numeric_limits<double>::infinity();
+  double max_val = -min_val;
+  for (std::size_t r = 0u; r < rows; r++)
+  {
+    const auto* row = image_row(data, r);
+    for (std::size_t c = 0u; c < cols; c++)
+    {
+      const double value = static_cast<double>(row[c]);
+      const bool is_finite = (value - value) == 0.0;
+      min_val = (is_finite && (value < min_val)) ? value : min_val;
+      max_val = (is_finite && (value > max_val)) ? value : max_val;
+    }
+  }
+  return (min_val <= max_val) ? std::make_pair(min_val, max_val) : std::make_pair(0.0, 0.0);
+}
+
+template<typename T>
+void fill_zmq_buffer(const colormap_encoded<T>& data, zmq::message_t& buffer)
+{
+  const auto [rows, cols] = container_shape(data.data);
+  double vmin = data.vmin, vmax = data.vmax;
+  if (std::isnan(vmin) || std::isnan(vmax))
+  {
+    const auto [min_val, max_val] = finite_min_max(data.data);
+    vmin = std::isnan(vmin) ? min_val : vmin;
+    vmax = std::isnan(vmax) ? max_val : vmax;
+  }
+  const double range = vmax - vmin;
+
+  // entry 256 holds the color of NaN
+  const auto& lut = colormap_lut(data.name);
+  std::array<std::uint8_t, 257u*4u> lut_rgba{};
+  for (std::size_t i = 0u; i < 256u; i++)
+  {
+    lut_rgba[4u*i]      = lut[3u*i];
+    lut_rgba[4u*i + 1u] = lut[3u*i + 1u];
+    lut_rgba[4u*i + 2u] = lut[3u*i + 2u];
+    lut_rgba[4u*i + 3u] = 255u;
+  }
+
+  const std::size_t channels = data.channels;
+  buffer.rebuild(rows*cols*channels);
+  auto * out = static_cast<std::uint8_t*>(buffer.data());
+
+  // same steps as matplotlib Normalize + Colormap: ((x - vmin)/(vmax - vmin))*256 truncated and clipped to [0, 255]
+  std::vector<std::uint16_t> lut_idx(cols);
+  for (std::size_t r = 0u; r < rows; r++)
+  {
+    const auto* row = image_row(data.data, r);
+    for (std::size_t c = 0u; c < cols; c++)
+    {
+      const double value  = static_cast<double>(row[c]);
+      const bool   is_nan = (value != value);
+      double scaled = (range > 0.0) ? ((value - vmin)/range)*256.0 : 0.0;
+      scaled = is_nan ? 0.0 : std::min(std::max(scaled, 0.0), 255.0);
+      lut_idx[c] = is_nan ? std::uint16_t{256u} : static_cast<std::uint16_t>(scaled);
+    }
+
+    std::uint8_t * out_row = out + r*cols*channels;
+    for (std::size_t c = 0u; c < cols; c++)
+    { std::memcpy(out_row + c*channels, lut_rgba.data() + 4u*lut_idx[c], channels); }
+  }
+}
+
+/*
+  * Downscaling of 2D containers to a display resolution before sending
+  * box: block mean, max: block max (max pooling), mode: most frequent value of the block (label/occupancy grids)
+  * Output pixel i covers the input rows [i*rows/out_rows, (i+1)*rows/out_rows) (same for cols), 
+  * python side also gets '<name>_extent' to use as imshow extent so axes stay in input pixel coordinates.
+  * Under server backpressure the target resolution is divided by 2^level (see cppyplot_fidelity.h).
+*/
+enum class resample { box, max, mode };
+
+template<typename T>
+struct downscaled{
+  using value_type = typename T::value_type;
+  const T&    data;
+  std::size_t rows;
+  std::size_t cols;
+  resample    method;
+};
+
+template<typename T>
+inline auto _downscale(std::pair<std::string, T&>&& arg, std::size_t rows, std::size_t cols, 
+                       resample method = resample::box)
+{ return std::make_pair(arg.first, downscaled<T>{arg.second, rows/fidelity().decimation(), cols/fidelity().decimation(), method}); }
+
+template<typename T>
+inline std::array<std::size_t, 2> container_shape(const downscaled<T>& data)
+{
+  const auto [rows, cols] = container_shape(data.data);
+  if ((rows == 0u) || (cols == 0u))
+  { return std::array<std::size_t, 2>{0u, 0u}; }
+  return std::array<std::size_t, 2>{std::clamp<std::size_t>(data.rows, 1u, std::max<std::size_t>(rows, 1u)),
+                                    std::clamp<std::size_t>(data.cols, 1u, std::max<std::size_t>(cols, 1u))};
+}
+
+template<typename T>
+inline std::size_t container_size(const downscaled<T>& data)
+{
+  const auto [rows, cols] = container_shape(data);
+  return rows*cols;
+}
+
+template<typename T>
+inline std::string container_encoding(const downscaled<T>& data)
+{
+  const auto [rows, cols] = container_shape(data.data);
+  return "downscale:" + std::to_string(rows) + "," + std::to_string(cols);
+}
+
+template<typename T>
+inline T block_mode(std::vector<T>& values)
+{
+  if constexpr (sizeof(T) == 1u)
+  {
+    std::array<std::size_t, 256> counts{};
+    for (const auto value : values)
+    { counts[static_cast<unsigned char>(value)]++; }
+    const auto best = std::max_element(counts.begin(), counts.end()) - counts.begin();
+    unsigned char byte = static_cast<unsigned char>(best);
+    T mode;
+    std::memcpy(&mode, &byte, 1u);
+    return mode;
+  }
+  else
+  {
+    // NaN sorts after every number (plain < is not a strict weak ordering with NaN), NaN never equals 
+    // itself so it is the mode only of an all NaN block
+    std::sort(values.begin(), values.end(), [](const T& a, const T& b) { return (a < b) || ((a == a) && (b != b)); });
+    T mode = values[0];
+    std::size_t best_run = 0u;
+    for (std::size_t i = 0u; i < values.size(); )
+    {
+      std::size_t j = i;
+      while ((j < values.size()) && (values[j] == values[i])) { j++; }
+      if ((j - i) > best_run) { best_run = j - i; mode = values[i]; }
+      i = (j == i) ? i + 1u : j;
+    }
+    return mode;
+  }
+}
+
+template<typename T>
+void fill_zmq_buffer(const downscaled<T>& data, zmq::message_t& buffer)
+{
+  using elem_t = image_elem_t<T>;
+  const auto [rows, cols]         = container_shape(data.data);
+  const auto [out_rows, out_cols] = container_shape(data);
+  buffer.rebuild(out_rows*out_cols*sizeof(elem_t));
+  elem_t * out = static_cast<elem_t*>(buffer.data());
+
+  // output pixel i covers input [start(i), start(i+1))
+  auto row_start = [rows = rows, out_rows = out_rows](std::size_t i) { return (i*rows)/out_rows; };
+  auto col_start = [cols = cols, out_cols = out_cols](std::size_t i) { return (i*cols)/out_cols; };
+
+  parallel_for(0u, out_rows, [&](std::size_t out_begin, std::size_t out_end)
+  {
+    std::vector<double> sum_acc;
+    std::vector<elem_t> max_acc;
+    std::vector<std::vector<elem_t>> blocks;
+    for (std::size_t i = out_begin; i < out_end; i++)
+    {
+      const std::size_t r0 = row_start(i), r1 = row_start(i + 1u);
+      elem_t * out_row = out + i*out_cols;
+
+      if (data.method == resample::box)
+      {
+        // accumulate the input rows column wise first (vectorized), then reduce each column block
+        sum_acc.assign(cols, 0.0);
+        for (std::size_t r = r0; r < r1; r++)
+        {
+          const elem_t* row = image_row(data.data, r);
+          for (std::size_t c = 0u; c < cols; c++)
+          { sum_acc[c] += static_cast<double>(row[c]); }
+        }
+        for (std::size_t j = 0u; j < out_cols; j++)
+        {
+          const std::size_t c0 = col_start(j), c1 = col_start(j + 1u);
+          const double mean = std::accumulate(sum_acc.begin() + c0, sum_acc.begin() + c1, 0.0)
+                              /static_cast<double>((r1 - r0)*(c1 - c0));
+          if constexpr (std::is_integral_v<elem_t>)
+          { out_row[j] = static_cast<elem_t>(std::floor(mean + 0.5)); }
+          else
+          { out_row[j] = static_cast<elem_t>(mean); }
+        }
+      }
+      else if (data.method == resample::max)
+      {
+        const elem_t* first_row = image_row(data.data, r0);
+        max_acc.assign(first_row, first_row + cols);
+        for (std::size_t r = r0 + 1u; r < r1; r++)
+        {
+          const elem_t* row = image_row(data.data, r);
+          for (std::size_t c = 0u; c < cols; c++)
+          { max_acc[c] = (row[c] > max_acc[c]) ? row[c] : max_acc[c]; }
+        }
+        for (std::size_t j = 0u; j < out_cols; j++)
+        {
+          const std::size_t c0 = col_start(j), c1 = col_start(j + 1u);
+          elem_t block_max = max_acc[c0];
+          for (std::size_t c = c0 + 1u; c < c1; c++)
+          { block_max = (max_acc[c] > block_max) ? max_acc[c] : block_max; }
+          out_row[j] = block_max;
+        }
+      }
+      else
+      {
+        // every input row is read once and split into the blocks of the output row
+        blocks.resize(out_cols);
+        for (auto& block : blocks)
+        { block.clear(); }
+        for (std::size_t r = r0; r < r1; r++)
+        {
+          const elem_t* row = image_row(data.data, r);
+          for (std::size_t j = 0u; j < out_cols; j++)
+          { blocks[j].insert(blocks[j].end(), row + col_start(j), row + col_start(j + 1u)); }
+        }
+        for (std::size_t j = 0u; j < out_cols; j++)
+        { out_row[j] = block_mode(blocks[j]); }
+      }
+    }
+  });
+}
+
+/*
+  * Tiled multi-resolution image pyramid for rasters too large to send at once
+  * Level 0 is the full resolution raster, every next level is a 2x2 box downsample of the previous one 
+  * until the level fits into a single tile. Level 0 is read from the caller's container (not copied),
+  * it has to stay alive and unchanged while the pyramid exists. Only a small descriptor is sent with _p(pyramid), python side 
+  * requests the tiles intersecting the current view (at the level matching the screen resolution) 
+  * over a REQ/REP socket served by a background thread, and caches every tile it received.
+  * request: (level, tile_row, tile_col) uint32 triplets, reply: requested tiles (row major each) back to back
+*/
+template<typename T>
+class image_pyramid{
+  public:
+    using value_type = T;
+
+    struct level_t{
+      std::size_t    rows;
+      std::size_t    cols;
+      std::vector<T> data;   // empty for level 0, its rows are read from the caller's container
+    };
+
+  private:
+    std::vector<level_t> levels_;
+    std::function<const T*(std::size_t)> base_row_;
+    std::size_t          tile_size_;
+    std::string          address_;
+    std::uint64_t        id_;
+    zmq::context_t       context_;
+    zmq::socket_t        socket_;
+    std::atomic<bool>    is_running_;
+    std::thread          server_thread_;
+
+    const T* level_row(std::size_t level, std::size_t row) const
+    {
+      const level_t& lvl = levels_[level];
+      return (level == 0u) ? base_row_(row) : (lvl.data.data() + row*lvl.cols);
+    }
+
+    level_t halve(std::size_t prev_level) const
+    {
+      const level_t& prev = levels_[prev_level];
+      level_t next{(prev.rows + 1u)/2u, (prev.cols + 1u)/2u, {}};
+      next.data.resize(next.rows*next.cols);
+      parallel_for(0u, next.rows, [&](std::size_t row_begin, std::size_t row_end)
+      {
+        for (std::size_t r = row_begin; r < row_end; r++)
+        {
+          const std::size_t r0 = 2u*r, r1 = std::min(prev.rows, r0 + 2u);
+          for (std::size_t c = 0u; c < next.cols; c++)
+          {
+            const std::size_t c0 = 2u*c, c1 = std::min(prev.cols, c0 + 2u);
+            double sum = 0.0;
+            for (std::size_t i = r0; i < r1; i++)
+            {
+              const T* row = level_row(prev_level, i);
+              for (std::size_t j = c0; j < c1; j++)
+              { sum += static_cast<double>(row[j]); }
+            }
+            const double mean = sum/static_cast<double>((r1 - r0)*(c1 - c0));
+            if constexpr (std::is_integral_v<T>)
+            { next.data[r*next.cols + c] = static_cast<T>(std::floor(mean + 0.5)); }
+            else
+            { next.data[r*next.cols + c] = static_cast<T>(mean); }
+          }
+        }
+      }, 16u);
+      return next;
+    }
+
+    void serve()
+    {
+      while (is_running_.load())
+      {
+        zmq::message_t request;
+        // times out every 50ms (rcvtimeo) to check is_running_
+        if (!socket_.recv(request, zmq::recv_flags::none))
+        { continue; }
+
+        std::vector<char> reply = tiles(static_cast<const std::uint32_t*>(request.data()), 
+                                        request.size()/(3u*sizeof(std::uint32_t)));
+        zmq::message_t reply_msg(reply.data(), reply.size());
+        socket_.send(reply_msg, zmq::send_flags::none);
+      }
+    }
+
+  public:
+    template<typename Container>
+    image_pyramid(const Container& data, const std::string& address = "tcp://127.0.0.1:5557", std::size_t tile_size = 256u)
+      : tile_size_(std::max<std::size_t>(tile_size, 1u)), address_(address),
+        id_(static_cast<std::uint64_t>(std::chrono::system_clock::now().time_since_epoch().count())),
+        context_(1), socket_(context_, zmq::socket_type::rep), is_running_(true)
+    {
+      const auto [rows, cols] = container_shape(data);
+      base_row_ = [&data](std::size_t row) { return image_row(data, row); };
+      levels_.push_back(level_t{rows, cols, {}});
+
+      while ((levels_.back().rows > tile_size_) || (levels_.back().cols > tile_size_))
+      { levels_.push_back(halve(levels_.size() - 1u)); }
+
+      socket_.set(zmq::sockopt::rcvtimeo, 50);
+      socket_.set(zmq::sockopt::linger, 0);
+      socket_.bind(address_);
+      server_thread_ = std::thread(&image_pyramid::serve, this);
+    }
+
+    // level 0 is referenced, a temporary raster would dangle
+    template<typename Container, typename = std::enable_if_t<!std::is_lvalue_reference_v<Container>>>
+    image_pyramid(Container&& data, const std::string& address = "tcp://127.0.0.1:5557", std::size_t tile_size = 256u) = delete;
+
+    image_pyramid(const image_pyramid& other) = delete;
+    image_pyramid& operator=(const image_pyramid& other) = delete;
+
+    ~image_pyramid()
+    {
+      is_running_.store(false);
+      if (server_thread_.joinable())
+      { server_thread_.join(); }
+    }
+
+    // requested tiles back to back, invalid requests are skipped
+    std::vector<char> tiles(const std::uint32_t* request, std::size_t n_tiles) const
+    {
+      std::vector<char> reply;
+      for (std::size_t i = 0u; i < n_tiles; i++)
+      {
+        const std::size_t level = request[3u*i], tile_row = request[3u*i + 1u], tile_col = request[3u*i + 2u];
+        if (level >= levels_.size())
+        { continue; }
+
+        const level_t& lvl = levels_[level];
+        const std::size_t r0 = tile_row*tile_size_, c0 = tile_col*tile_size_;
+        if ((r0 >= lvl.rows) || (c0 >= lvl.cols))
+        { continue; }
+
+        const std::size_t r1 = std::min(lvl.rows, r0 + tile_size_), c1 = std::min(lvl.cols, c0 + tile_size_);
+        for (std::size_t r = r0; r < r1; r++)
+        {
+          const char* row = reinterpret_cast<const char*>(level_row(level, r) + c0);
+          reply.insert(reply.end(), row, row + (c1 - c0)*sizeof(T));
+        }
+      }
+      return reply;
+    }
+
+    const std::vector<level_t>& levels() const noexcept
+    { return levels_; }
+
+    std::size_t tile_size() const noexcept
+    { return tile_size_; }
+
+    const std::string& address() const noexcept
+    { return address_; }
+
+    // identifies the raster, python side drops its tile cache when a different pyramid is sent
+    std::uint64_t id() const noexcept
+    { return id_; }
+};
+
+template<typename Container, typename... Args>
+image_pyramid(const Container& data, Args&&... args) -> image_pyramid<image_elem_t<Container>>;
+
+/* descriptor: [id, tile_size, n_levels, rows_0, cols_0, rows_1, cols_1, ...] (uint64) */
+template<typename T>
+inline std::size_t container_size(const image_pyramid<T>& data)
+{ return data.levels()[0].rows*data.levels()[0].cols; }
+
+template<typename T>
+inline std::array<std::size_t, 2> container_shape(const image_pyramid<T>& data)
+{ return std::array<std::size_t, 2>{data.levels()[0].rows, data.levels()[0].cols}; }
+
+template<typename T>
+inline std::string container_encoding(const image_pyramid<T>& data)
+{ return "pyramid:" + data.address(); }
+
+template<typename T>
+void fill_zmq_buffer(const image_pyramid<T>& data, zmq::message_t& buffer)
+{
+  std::vector<std::uint64_t> descriptor{data.id(), data.tile_size(), data.levels().size()};
+  for (const auto& level : data.levels())
+  {
+    descriptor.push_back(level.rows);
+    descriptor.push_back(level.cols);
+  }
+  buffer.rebuild(descriptor.data(), descriptor.size()*sizeof(std::uint64_t));
+}
+
+#endif
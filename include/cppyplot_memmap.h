@@ -0,0 +1,239 @@
+#ifndef _CPPYPLOT_MEMMAP_H_
+#define _CPPYPLOT_MEMMAP_H_
+
+/*
+  * Out-of-core arrays, for data larger than RAM (simulation outputs): only the file path, dtype, shape and data offset
+  * are sent, python side opens the file with np.memmap (read only) so plot scripts slice or decimate it lazily
+  * and only the touched pages are read. The server has to see the same file system.
+  * npy_file<T> is a .npy file that grows by appending rows of a fixed row shape (buffered sequential writes),
+  * _p(file) sends the rows appended so far. _memmap(_p(container), path) writes a container once and sends the same reference.
+  * The header of a npy_file reserves room for a 20 digit row count and is rewritten whenever the file is sent or flushed,
+  * so np.load(path, mmap_mode="r") also works on the file while it grows.
+  * payload: absolute path (utf-8), encoding "memmap:<data offset>"
+*/
+constexpr std::size_t NPY_FILE_BUFFER = std::size_t{1u} << 22u;
+
+template<typename T>
+struct memmap_ref{
+  using value_type = T;
+  std::string              path;
+  std::vector<std::size_t> shape;
+  std::uint64_t            offset = 0u;
+};
+
+template<typename T>
+inline std::size_t container_size(const memmap_ref<T>& data)
+{ return std::accumulate(data.shape.begin(), data.shape.end(), std::size_t{1u}, std::multiplies<std::size_t>()); }
+
+template<typename T>
+inline const std::vector<std::size_t>& container_shape(const memmap_ref<T>& data)
+{ return data.shape; }
+
+template<typename T>
+inline std::string container_encoding(const memmap_ref<T>& data)
+{ return "memmap:" + std::to_string(data.offset); }
+
+template<typename T>
+inline void fill_zmq_buffer(const memmap_ref<T>& data, zmq::message_t& buffer)
+{ buffer.rebuild(data.path.data(), data.path.size()); }
+
+template<typename T>
+class npy_file{
+  static_assert(is_scalar_v<T>, "npy_file elements have to be scalars, the row shape gives the trailing dimensions");
+  private:
+    std::FILE *               file_ = nullptr;
+    std::string               path_;
+    std::vector<std::size_t>  row_shape_;
+    std::size_t               row_elems_;
+    std::uint64_t             rows_ = 0u;
+    std::size_t               header_size_;
+
+    std::string header(std::uint64_t rows) const
+    {
+      std::vector<std::size_t> shape{static_cast<std::size_t>(rows)};
+      shape.insert(shape.end(), row_shape_.begin(), row_shape_.end());
+      return npy_header(dtype_str(unpack_type<T>()), shape_str(shape), header_size_);
+    }
+
+  public:
+    using value_type = T;
+
+    // creates (replaces) 'path', every row holds prod(row_shape) elements, an empty row shape gives a 1D array
+    explicit npy_file(const std::string& path, std::vector<std::size_t> row_shape = {})
+      : row_shape_(std::move(row_shape)),
+        row_elems_(std::accumulate(row_shape_.begin(), row_shape_.end(), std::size_t{1u}, std::multiplies<std::size_t>())),
+        header_size_(0u)
+    {
+      header_size_ = header(std::numeric_limits<std::uint64_t>::max()).size();
+      std::error_code error;
+      path_ = std::filesystem::absolute(path, error).string();
+      // a new inode, a server that still maps the previous file keeps reading that one (truncating it would SIGBUS)
+      std::filesystem::remove(path_, error);
+      file_ = std::fopen(path_.c_str(), "wb");
+      if (file_ == nullptr)
+      { return; }
+      std::setvbuf(file_, nullptr, _IOFBF, NPY_FILE_BUFFER);
+      const std::string text = header(0u);
+      std::fwrite(text.data(), 1u, text.size(), file_);
+    }
+
+    npy_file(const npy_file&) = delete;
+    npy_file& operator=(const npy_file&) = delete;
+    ~npy_file()
+    { close(); }
+
+    bool is_open() const noexcept
+    { return file_ != nullptr; }
+
+    // appends n_rows rows (n_rows x prod(row_shape) elements)
+    void append(const T* rows, std::size_t n_rows)
+    {
+      if ((file_ == nullptr) || (n_rows == 0u))
+      { return; }
+      rows_ += std::fwrite(rows, sizeof(T)*row_elems_, n_rows, file_);
+    }
+
+    void append(const std::vector<T>& rows)
+    { append(rows.data(), rows.size()/row_elems_); }
+
+    // writes the buffered rows and the header with the current row count
+    void flush() const
+    {
+      if (file_ == nullptr)
+      { return; }
+      const std::string text = header(rows_);
+      std::fflush(file_);
+      std::fseek(file_, 0, SEEK_SET);
+      std::fwrite(text.data(), 1u, text.size(), file_);
+      std::fseek(file_, 0, SEEK_END);
+      std::fflush(file_);
+    }
+
+    void close()
+    {
+      if (file_ == nullptr)
+      { return; }
+      flush();
+      std::fclose(file_);
+      file_ = nullptr;
+    }
+
+    std::uint64_t rows() const noexcept
+    { return rows_; }
+
+    const std::string& path() const noexcept
+    { return path_; }
+
+    std::vector<std::size_t> shape() const
+    {
+      std::vector<std::size_t> shape{static_cast<std::size_t>(rows_)};
+      shape.insert(shape.end(), row_shape_.begin(), row_shape_.end());
+      return shape;
+    }
+
+    // offset of the first row in the file
+    std::size_t data_offset() const noexcept
+    { return header_size_; }
+
+    // references the rows appended so far (flush() before the file is read)
+    memmap_ref<T> reference() const
+    { return memmap_ref<T>{path_, shape(), header_size_}; }
+};
+
+template<typename T>
+inline std::size_t container_size(const npy_file<T>& data)
+{ return container_size(data.reference()); }
+
+template<typename T>
+inline std::vector<std::size_t> container_shape(const npy_file<T>& data)
+{ return data.shape(); }
+
+template<typename T>
+inline std::string container_encoding(const npy_file<T>& data)
+{ return "memmap:" + std::to_string(data.data_offset()); }
+
+// the rows written so far are flushed before the path is sent
+template<typename T>
+inline void fill_zmq_buffer(const npy_file<T>& data, zmq::message_t& buffer)
+{
+  data.flush();
+  buffer.rebuild(data.path().data(), data.path().size());
+}
+
+/*
+  * element data of a container in .npy order, nested containers are written row by row,
+  * the others straight from their storage (fill_zmq_buffer references it without a copy)
+*/
+template<typename T>
+inline bool memmap_write(std::FILE * file, const std::vector<std::vector<T>>& data)
+{
+  const std::size_t cols = data.empty() ? 0u : data[0].size();
+  for (const auto& row : data)
+  {
+    if (std::fwrite(row.data(), sizeof(T), cols, file) != cols)
+    { return false; }
+  }
+  return true;
+}
+
+template<typename T, std::size_t N, std::size_t M>
+inline bool memmap_write(std::FILE * file, const std::array<std::array<T, M>, N>& data)
+{
+  for (const auto& row : data)
+  {
+    if (std::fwrite(row.data(), sizeof(T), M, file) != M)
+    { return false; }
+  }
+  return true;
+}
+
+template<typename T>
+inline bool memmap_write(std::FILE * file, const T& data)
+{
+  zmq::message_t payload;
+  fill_zmq_buffer(data, payload);
+  return std::fwrite(payload.data(), 1u, payload.size(), file) == payload.size();
+}
+
+/*
+  * Writes 'arg' to the .npy file 'path' and sends it as an out-of-core array,
+  * pyp.raw("ax.plot(x[::100])", _memmap(_p(x), "x.npy")) reads every 100th element only.
+  * The file is written next to 'path' and renamed over it, a server that still maps the previous
+  * file keeps reading that one. Where it cannot be replaced (mapped on windows) the new file keeps its temporary name.
+*/
+template<typename T>
+inline auto _memmap(std::pair<std::string, T&>&& arg, const std::string& path)
+{
+  static_assert((container_frames_v<T> == 1u) && !std::is_same_v<std::remove_cv_t<T>, std::vector<bool>>,
+                "only containers sent as one raw frame can be memory mapped");
+  using value_t = typename std::remove_cv_t<T>::value_type;
+
+  memmap_ref<value_t> ref;
+  std::error_code error;
+  ref.path = std::filesystem::absolute(path, error).string();
+  const auto shape = container_shape(arg.second);
+  ref.shape.assign(shape.begin(), shape.end());
+
+  const std::string text = npy_header(dtype_str(unpack_type<T>()), shape_str(ref.shape));
+  ref.offset = text.size();
+
+  static std::atomic<std::uint64_t> n_written{0u};
+  const std::string temp_path = ref.path + ".tmp" + std::to_string(n_written.fetch_add(1u)) + "_"
+                              + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+  std::FILE * file = std::fopen(temp_path.c_str(), "wb");
+  if (file == nullptr)
+  { return std::make_pair(arg.first, std::move(ref)); }
+  bool written = (std::fwrite(text.data(), 1u, text.size(), file) == text.size()) && memmap_write(file, arg.second);
+  written = (std::fclose(file) == 0) && written;
+  if (!written)
+  { std::filesystem::remove(temp_path, error); }
+  else
+  {
+    std::filesystem::rename(temp_path, ref.path, error);
+    if (error)
+    { ref.path = temp_path; }
+  }
+  return std::make_pair(arg.first, std::move(ref));
+}
+
+#endif
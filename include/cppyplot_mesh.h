@@ -0,0 +1,249 @@
+#ifndef _CPPYPLOT_MESH_H_
+#define _CPPYPLOT_MESH_H_
+
+/*
+  * Triangle meshes for plot_trisurf, Poly3DCollection or VTK style viewers.
+  * Vertices (N x 3) and faces (F x 3 vertex indices, wider rows are sent as polygons) are sent as two frames,
+  * row major contiguous containers (vector<array<T,M>>, array<array<T,M>,N>, row major Eigen) are sent zero-copy,
+  * other layouts are copied row by row.
+  * narrow_indices   : 64bit face indices are sent as uint32 when the vertex count fits.
+  * drop_unreferenced: vertices not used by any face are removed and the faces renumbered,
+  *                    faces referring to vertices out of range are dropped.
+  * Python side gets a TriangleMesh (vertices, faces) with plot_trisurf(), poly3d(), triangulation() and vtk_faces().
+*/
+
+// innermost value_type of nested containers (vector<array<float,3>> -> float)
+template<typename T, typename = void>
+struct scalar_of { using type = T; };
+
+template<typename T>
+struct scalar_of<T, std::void_t<typename T::value_type>> { using type = typename scalar_of<typename T::value_type>::type; };
+
+// containers that store their rows back to back in one buffer
+template<typename T>
+struct contiguous_rows : std::false_type {};
+
+template<typename T, std::size_t M>
+struct contiguous_rows<std::vector<std::array<T, M>>> : std::bool_constant<sizeof(std::array<T, M>) == M*sizeof(T)> {};
+
+template<typename T, std::size_t N, std::size_t M>
+struct contiguous_rows<std::array<std::array<T, M>, N>> : std::bool_constant<sizeof(std::array<T, M>) == M*sizeof(T)> {};
+
+template<typename T, std::size_t M>
+inline const void* rows_data(const std::vector<std::array<T, M>>& data)
+{ return data.data(); }
+
+template<typename T, std::size_t N, std::size_t M>
+inline const void* rows_data(const std::array<std::array<T, M>, N>& data)
+{ return data.data(); }
+
+#if defined (EIGEN_AVAILABLE)
+template<typename Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+struct contiguous_rows<Eigen::Matrix<Scalar, Rows, Cols, Options, MaxRows, MaxCols>> : std::bool_constant<(Options & Eigen::RowMajor) != 0> {};
+
+template<typename Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+struct contiguous_rows<Eigen::Array<Scalar, Rows, Cols, Options, MaxRows, MaxCols>> : std::bool_constant<(Options & Eigen::RowMajor) != 0> {};
+
+template<typename Derived>
+inline const void* rows_data(const Eigen::PlainObjectBase<Derived>& data)
+{ return data.data(); }
+#endif
+
+template<typename S>
+struct mesh_buffers{
+  std::size_t       n_vertices  = 0u;
+  std::size_t       n_dims      = 0u;
+  std::size_t       n_faces     = 0u;
+  std::size_t       face_size   = 0u;
+  char              index_type  = 'q';
+  bool              copy_vertices = false;
+  bool              copy_faces    = false;
+  std::vector<S>    vertices;   // used when copy_vertices is set
+  std::vector<char> faces;      // used when copy_faces is set, elements of index_type
+};
+
+template<typename V, typename F>
+struct triangle_mesh{
+  using value_type = typename scalar_of<V>::type;
+  const V& vertices;
+  const F& faces;
+  bool     narrow_indices;
+  bool     drop_unreferenced;
+  // compacted buffers are computed once, header and payload frames are created from the same result
+  mutable std::shared_ptr<mesh_buffers<value_type>> buffers;
+};
+
+template<typename V, typename F>
+inline auto _mesh(std::pair<std::string, V&>&& vertices, const F& faces,
+                  bool narrow_indices = false, bool drop_unreferenced = false)
+{ return std::make_pair(vertices.first, triangle_mesh<V, F>{vertices.second, faces, narrow_indices, drop_unreferenced, nullptr}); }
+
+template<typename V, typename F>
+const mesh_buffers<typename triangle_mesh<V, F>::value_type>& prepared_mesh(const triangle_mesh<V, F>& mesh)
+{
+  using vertex_t = typename triangle_mesh<V, F>::value_type;
+  using index_t  = typename scalar_of<F>::type;
+  static_assert(std::is_integral_v<index_t>, "face indices have to be integral");
+
+  if (mesh.buffers)
+  { return *mesh.buffers; }
+
+  auto buffers = std::make_shared<mesh_buffers<vertex_t>>();
+  const std::size_t n_vertices = sample_count(mesh.vertices);
+  const std::size_t n_dims     = sample_dims(mesh.vertices);
+  const std::size_t n_faces    = sample_count(mesh.faces);
+  const std::size_t face_size  = sample_dims(mesh.faces);
+  constexpr std::size_t unused = std::numeric_limits<std::size_t>::max();
+
+  // new index of every vertex (unused if it is not referenced) and the faces that are kept
+  std::vector<std::size_t> remap;
+  std::vector<std::size_t> kept_faces;
+  std::size_t n_used = n_vertices;
+  if (mesh.drop_unreferenced)
+  {
+    remap.assign(n_vertices, unused);
+    kept_faces.reserve(n_faces);
+    for (std::size_t f = 0u; f < n_faces; f++)
+    {
+      bool valid = true;
+      for (std::size_t c = 0u; c < face_size; c++)
+      {
+        const double idx = sample_at(mesh.faces, f, c);
+        valid = valid && (idx >= 0.0) && (idx < static_cast<double>(n_vertices));
+      }
+      if (!valid)
+      { continue; }
+      kept_faces.push_back(f);
+      for (std::size_t c = 0u; c < face_size; c++)
+      { remap[static_cast<std::size_t>(sample_at(mesh.faces, f, c))] = 0u; }
+    }
+    n_used = 0u;
+    for (std::size_t v = 0u; v < n_vertices; v++)
+    { remap[v] = (remap[v] == unused) ? unused : n_used++; }
+  }
+
+  buffers->n_vertices    = n_used;
+  buffers->n_dims        = n_dims;
+  buffers->n_faces       = mesh.drop_unreferenced ? kept_faces.size() : n_faces;
+  buffers->face_size     = face_size;
+  const bool narrow      = mesh.narrow_indices && (sizeof(index_t) == 8u) && (n_used <= (std::size_t{1u} << 32u));
+  buffers->index_type    = narrow ? integral_typestr<std::uint32_t>() : integral_typestr<index_t>();
+  buffers->copy_vertices = mesh.drop_unreferenced || !contiguous_rows<V>::value;
+  buffers->copy_faces    = mesh.drop_unreferenced || narrow || !contiguous_rows<F>::value;
+
+  if (buffers->copy_vertices)
+  {
+    buffers->vertices.resize(n_used*n_dims);
+    vertex_t * out = buffers->vertices.data();
+    parallel_for(0u, n_vertices, [&](std::size_t begin, std::size_t end)
+    {
+      for (std::size_t v = begin; v < end; v++)
+      {
+        const std::size_t dst = mesh.drop_unreferenced ? remap[v] : v;
+        if (dst == unused)
+        { continue; }
+        for (std::size_t d = 0u; d < n_dims; d++)
+        { out[dst*n_dims + d] = static_cast<vertex_t>(sample_at(mesh.vertices, v, d)); }
+      }
+    }, 1u << 16u);
+  }
+
+  if (buffers->copy_faces)
+  {
+    auto copy_faces = [&](auto * out)
+    {
+      using out_t = std::remove_pointer_t<decltype(out)>;
+      parallel_for(0u, buffers->n_faces, [&](std::size_t begin, std::size_t end)
+      {
+        for (std::size_t k = begin; k < end; k++)
+        {
+          const std::size_t f = mesh.drop_unreferenced ? kept_faces[k] : k;
+          for (std::size_t c = 0u; c < face_size; c++)
+          {
+            const auto idx = static_cast<std::int64_t>(sample_at(mesh.faces, f, c));
+            out[k*face_size + c] = static_cast<out_t>(mesh.drop_unreferenced ? remap[static_cast<std::size_t>(idx)]
+                                                                              : static_cast<std::size_t>(idx));
+          }
+        }
+      }, 1u << 16u);
+    };
+    const std::size_t n_indices = buffers->n_faces*face_size;
+    if (narrow)
+    {
+      buffers->faces.resize(sizeof(std::uint32_t)*n_indices);
+      copy_faces(reinterpret_cast<std::uint32_t*>(buffers->faces.data()));
+    }
+    else
+    {
+      buffers->faces.resize(sizeof(index_t)*n_indices);
+      copy_faces(reinterpret_cast<index_t*>(buffers->faces.data()));
+    }
+  }
+
+  mesh.buffers = std::move(buffers);
+  return *mesh.buffers;
+}
+
+template<typename V, typename F>
+inline std::size_t container_size(const triangle_mesh<V, F>& data)
+{
+  const auto& prepared = prepared_mesh(data);
+  return prepared.n_vertices*prepared.n_dims;
+}
+
+template<typename V, typename F>
+inline std::array<std::size_t, 2> container_shape(const triangle_mesh<V, F>& data)
+{
+  const auto& prepared = prepared_mesh(data);
+  return std::array<std::size_t, 2>{prepared.n_vertices, prepared.n_dims};
+}
+
+template<typename V, typename F>
+inline std::string container_encoding(const triangle_mesh<V, F>& data)
+{
+  const auto& prepared = prepared_mesh(data);
+  return std::string("mesh:") + prepared.index_type + "," + std::to_string(prepared.n_faces) + ","
+                              + std::to_string(prepared.face_size);
+}
+
+template<typename V, typename F>
+struct container_frames<triangle_mesh<V, F>> : std::integral_constant<std::size_t, 2u> {};
+
+template<typename V, typename F>
+void fill_zmq_buffer(const triangle_mesh<V, F>& data, std::size_t frame, zmq::message_t& buffer)
+{
+  using vertex_t = typename triangle_mesh<V, F>::value_type;
+  using index_t  = typename scalar_of<F>::type;
+  const auto& prepared = prepared_mesh(data);
+
+  if (frame == 0u)
+  {
+    const std::size_t n_bytes = sizeof(vertex_t)*prepared.n_vertices*prepared.n_dims;
+    if constexpr (contiguous_rows<V>::value)
+    {
+      if (!prepared.copy_vertices)
+      {
+        buffer.rebuild((void*)rows_data(data.vertices), n_bytes, custom_dealloc, nullptr);
+        return;
+      }
+    }
+    buffer.rebuild(n_bytes);
+    if (n_bytes > 0u)
+    { std::memcpy(buffer.data(), prepared.vertices.data(), n_bytes); }
+    return;
+  }
+
+  if constexpr (contiguous_rows<F>::value)
+  {
+    if (!prepared.copy_faces)
+    {
+      buffer.rebuild((void*)rows_data(data.faces), sizeof(index_t)*prepared.n_faces*prepared.face_size, custom_dealloc, nullptr);
+      return;
+    }
+  }
+  buffer.rebuild(prepared.faces.size());
+  if (!prepared.faces.empty())
+  { std::memcpy(buffer.data(), prepared.faces.data(), prepared.faces.size()); }
+}
+
+#endif
@@ -0,0 +1,423 @@
+#ifndef _CPPYPLOT_OFFLINE_H_
+#define _CPPYPLOT_OFFLINE_H_
+
+/*
+  * Offline capture for hosts without python: with cppyplot::set_offline(directory) nothing is sent to a server,
+  * every message (pyp.raw call, watch batch, ...) is written as one call instead.
+  * npy: directory/call_000042/<name>.npy, script.py (plot commands) and headers.txt
+  * npz: directory/session.npz with the same files as members call_000042/<name>.npy, ... (stored, zip64),
+  *      np.load(path)["call_000042/<name>"] returns the array, the central directory is written by close().
+  * Raw containers are written as .npy (strings as .txt), other encodings (histograms, gorilla, ...) keep their wire
+  * frames as <name>.<frame>.bin, decoded by cppyplot_server.py when the directory is replayed with cppyplot_replay.py.
+  * headers.txt: "# t=<ns since capture start>" followed by one "<file name>\t<wire header>" line per container.
+  * Frames are copied while sending and written by one background thread in call order, writing blocks
+  * when more than OFFLINE_QUEUE_BYTES are waiting.
+*/
+constexpr std::size_t OFFLINE_QUEUE_BYTES = std::size_t{256u} << 20u;
+
+enum class offline_format { npy, npz };
+
+/* CRC-32 (zip), slicing by 8 */
+inline std::uint32_t crc32_update(std::uint32_t crc, const unsigned char* data, std::size_t size) noexcept
+{
+  static const auto tables = []()
+  {
+    std::array<std::array<std::uint32_t, 256>, 8> table{};
+    for (std::uint32_t i = 0u; i < 256u; i++)
+    {
+      std::uint32_t value = i;
+      for (int bit = 0; bit < 8; bit++)
+      { value = (value & 1u) ? (0xEDB88320u ^ (value >> 1u)) : (value >> 1u); }
+      table[0][i] = value;
+    }
+    for (std::size_t slice = 1u; slice < 8u; slice++)
+    {
+      for (std::size_t i = 0u; i < 256u; i++)
+      { table[slice][i] = (table[slice - 1u][i] >> 8u) ^ table[0][table[slice - 1u][i] & 0xFFu]; }
+    }
+    return table;
+  }();
+
+  crc = ~crc;
+  for (; size >= 8u; size -= 8u, data += 8u)
+  {
+    const std::uint32_t low  = crc ^ (  static_cast<std::uint32_t>(data[0])        | (static_cast<std::uint32_t>(data[1]) << 8u)
+                                      | (static_cast<std::uint32_t>(data[2]) << 16u) | (static_cast<std::uint32_t>(data[3]) << 24u));
+    const std::uint32_t high =          static_cast<std::uint32_t>(data[4])        | (static_cast<std::uint32_t>(data[5]) << 8u)
+                                      | (static_cast<std::uint32_t>(data[6]) << 16u) | (static_cast<std::uint32_t>(data[7]) << 24u);
+    crc = tables[7][low & 0xFFu] ^ tables[6][(low >> 8u) & 0xFFu] ^ tables[5][(low >> 16u) & 0xFFu] ^ tables[4][low >> 24u]
+        ^ tables[3][high & 0xFFu] ^ tables[2][(high >> 8u) & 0xFFu] ^ tables[1][(high >> 16u) & 0xFFu] ^ tables[0][high >> 24u];
+  }
+  for (; size > 0u; size--, data++)
+  { crc = tables[0][(crc ^ *data) & 0xFFu] ^ (crc >> 8u); }
+  return ~crc;
+}
+
+/* .npy (version 1.0) header of a C ordered array, padded to at least 'min_size' bytes (headers rewritten in place) */
+inline std::string npy_header(const std::string& dtype, const std::string& shape, std::size_t min_size = 0u)
+{
+  const std::uint16_t probe = 1u;
+  const char byte_order = (*reinterpret_cast<const unsigned char*>(&probe) == 1u) ? '<' : '>';
+  std::string dict = "{'descr': '" + std::string(1u, byte_order) + dtype + "', 'fortran_order': False, 'shape': " + shape + ", }";
+  // magic, version and header length take 10 bytes, the data starts 64 byte aligned
+  dict.append(63u - (10u + dict.size()) % 64u, ' ');
+  if ((10u + dict.size() + 1u) < min_size)
+  { dict.append(min_size - (10u + dict.size() + 1u), ' '); }
+  dict.push_back('\n');
+
+  std::string header("\x93NUMPY\x01\x00", 8u);
+  header.push_back(static_cast<char>(dict.size() & 0xFFu));
+  header.push_back(static_cast<char>(dict.size() >> 8u));
+  return header + dict;
+}
+
+class offline_writer{
+  private:
+    struct file_job{
+      std::string       call;     // call_000042
+      std::string       name;     // file name within the call
+      std::string       prefix;   // .npy header
+      std::vector<char> data;
+    };
+
+    struct zip_entry{
+      std::string   name;
+      std::uint32_t crc;
+      std::uint64_t size;
+      std::uint64_t offset;
+    };
+
+    std::filesystem::path  directory_;
+    offline_format         format_ = offline_format::npy;
+    bool                   open_   = false;
+    std::int64_t           start_  = 0;
+
+    // call being assembled, producer side (send_lock() held)
+    std::uint64_t             n_calls_ = 0u;
+    std::string               call_;
+    std::string               header_lines_;
+    bool                      call_started_ = false;
+    std::vector<std::string>  fields_;       // wire header of the container whose frames follow
+    std::size_t               frame_ = 0u;
+
+    // background writer
+    std::mutex             lock_;
+    std::condition_variable work_;
+    std::condition_variable space_;
+    std::deque<file_job>   jobs_;
+    std::size_t            queued_bytes_ = 0u;
+    bool                   running_      = false;
+    std::thread            thread_;
+
+    // npz archive, writer thread only
+    std::FILE *            zip_ = nullptr;
+    std::uint64_t          zip_offset_ = 0u;
+    std::vector<zip_entry> zip_entries_;
+    std::string            created_call_;
+
+    static std::int64_t now_ns() noexcept
+    { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+
+    // variable names are expressions (_p(a.b[0])), file names keep [A-Za-z0-9_.-]
+    static std::string file_stem(const std::string& name)
+    {
+      std::string stem(name);
+      for (auto& c : stem)
+      { c = (std::isalnum(static_cast<unsigned char>(c)) || (c == '_') || (c == '-') || (c == '.')) ? c : '_'; }
+      return stem;
+    }
+
+    static std::vector<std::string> split(const std::string& text, char separator)
+    {
+      std::vector<std::string> parts;
+      std::size_t begin = 0u;
+      for (std::size_t end = text.find(separator); end != std::string::npos; end = text.find(separator, begin))
+      {
+        parts.push_back(text.substr(begin, end - begin));
+        begin = end + 1u;
+      }
+      parts.push_back(text.substr(begin));
+      return parts;
+    }
+
+    void enqueue(file_job&& job)
+    {
+      std::unique_lock<std::mutex> lock(lock_);
+      const std::size_t bytes = job.prefix.size() + job.data.size();
+      space_.wait(lock, [&](){ return (queued_bytes_ == 0u) || (queued_bytes_ + bytes <= OFFLINE_QUEUE_BYTES); });
+      queued_bytes_ += bytes;
+      jobs_.push_back(std::move(job));
+      work_.notify_one();
+    }
+
+    void enqueue(const std::string& name, const std::string& prefix, const char* data, std::size_t size)
+    { enqueue(file_job{call_, name, prefix, std::vector<char>(data, data + size)}); }
+
+    template<typename T>
+    void put(std::string& out, T value)
+    { out.append(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+    void write_job(const file_job& job)
+    {
+      if (format_ == offline_format::npy)
+      {
+        const std::filesystem::path call_dir = directory_/job.call;
+        if (created_call_ != job.call)
+        {
+          std::error_code error;
+          std::filesystem::create_directories(call_dir, error);
+          created_call_ = job.call;
+        }
+        std::FILE * file = std::fopen((call_dir/job.name).string().c_str(), "wb");
+        if (file == nullptr)
+        { return; }
+        std::fwrite(job.prefix.data(), 1u, job.prefix.size(), file);
+        std::fwrite(job.data.data(), 1u, job.data.size(), file);
+        std::fclose(file);
+        return;
+      }
+
+      // stored member with zip64 sizes in the local header
+      zip_entry entry{job.call + "/" + job.name, 0u, job.prefix.size() + job.data.size(), zip_offset_};
+      entry.crc = crc32_update(0u, reinterpret_cast<const unsigned char*>(job.prefix.data()), job.prefix.size());
+      entry.crc = crc32_update(entry.crc, reinterpret_cast<const unsigned char*>(job.data.data()), job.data.size());
+
+      std::string header;
+      put(header, std::uint32_t{0x04034b50u});
+      put(header, std::uint16_t{45u});              // version needed (zip64)
+      put(header, std::uint16_t{0x0800u});          // utf-8 names
+      put(header, std::uint16_t{0u});               // stored
+      put(header, std::uint16_t{0u});               // time
+      put(header, std::uint16_t{0x0021u});          // date (1980-01-01)
+      put(header, entry.crc);
+      put(header, std::uint32_t{0xFFFFFFFFu});
+      put(header, std::uint32_t{0xFFFFFFFFu});
+      put(header, static_cast<std::uint16_t>(entry.name.size()));
+      put(header, std::uint16_t{20u});
+      header += entry.name;
+      put(header, std::uint16_t{0x0001u});
+      put(header, std::uint16_t{16u});
+      put(header, entry.size);
+      put(header, entry.size);
+
+      std::fwrite(header.data(), 1u, header.size(), zip_);
+      std::fwrite(job.prefix.data(), 1u, job.prefix.size(), zip_);
+      std::fwrite(job.data.data(), 1u, job.data.size(), zip_);
+      zip_offset_ += header.size() + entry.size;
+      zip_entries_.push_back(std::move(entry));
+    }
+
+    void finish_zip()
+    {
+      std::string directory;
+      for (const auto& entry : zip_entries_)
+      {
+        put(directory, std::uint32_t{0x02014b50u});
+        put(directory, std::uint16_t{45u});
+        put(directory, std::uint16_t{45u});
+        put(directory, std::uint16_t{0x0800u});
+        put(directory, std::uint16_t{0u});
+        put(directory, std::uint16_t{0u});
+        put(directory, std::uint16_t{0x0021u});
+        put(directory, entry.crc);
+        put(directory, std::uint32_t{0xFFFFFFFFu});
+        put(directory, std::uint32_t{0xFFFFFFFFu});
+        put(directory, static_cast<std::uint16_t>(entry.name.size()));
+        put(directory, std::uint16_t{28u});
+        put(directory, std::uint16_t{0u});          // comment
+        put(directory, std::uint16_t{0u});          // disk
+        put(directory, std::uint16_t{0u});          // internal attributes
+        put(directory, std::uint32_t{0u});          // external attributes
+        put(directory, std::uint32_t{0xFFFFFFFFu}); // offset (zip64)
+        directory += entry.name;
+        put(directory, std::uint16_t{0x0001u});
+        put(directory, std::uint16_t{24u});
+        put(directory, entry.size);
+        put(directory, entry.size);
+        put(directory, entry.offset);
+      }
+
+      const std::uint64_t directory_offset = zip_offset_;
+      const std::uint64_t directory_size   = directory.size();
+      const std::uint64_t n_entries        = zip_entries_.size();
+      // zip64 end of central directory, its locator and the classic end record pointing at them
+      put(directory, std::uint32_t{0x06064b50u});
+      put(directory, std::uint64_t{44u});
+      put(directory, std::uint16_t{45u});
+      put(directory, std::uint16_t{45u});
+      put(directory, std::uint32_t{0u});
+      put(directory, std::uint32_t{0u});
+      put(directory, n_entries);
+      put(directory, n_entries);
+      put(directory, directory_size);
+      put(directory, directory_offset);
+      put(directory, std::uint32_t{0x07064b50u});
+      put(directory, std::uint32_t{0u});
+      put(directory, directory_offset + directory_size);
+      put(directory, std::uint32_t{1u});
+      put(directory, std::uint32_t{0x06054b50u});
+      put(directory, std::uint16_t{0u});
+      put(directory, std::uint16_t{0u});
+      put(directory, std::uint16_t{0xFFFFu});
+      put(directory, std::uint16_t{0xFFFFu});
+      put(directory, std::uint32_t{0xFFFFFFFFu});
+      put(directory, std::uint32_t{0xFFFFFFFFu});
+      put(directory, std::uint16_t{0u});
+      std::fwrite(directory.data(), 1u, directory.size(), zip_);
+    }
+
+    void run()
+    {
+      std::unique_lock<std::mutex> lock(lock_);
+      while (running_ || !jobs_.empty())
+      {
+        if (jobs_.empty())
+        {
+          work_.wait(lock);
+          continue;
+        }
+        file_job job = std::move(jobs_.front());
+        jobs_.pop_front();
+        lock.unlock();
+        write_job(job);
+        lock.lock();
+        queued_bytes_ -= job.prefix.size() + job.data.size();
+        space_.notify_all();
+      }
+    }
+
+    // headers.txt completes a call, written when the next message starts (watch batches have no finalize)
+    void finish_call()
+    {
+      if (!call_started_)
+      { return; }
+      enqueue("headers.txt", "", header_lines_.data(), header_lines_.size());
+      call_started_ = false;
+    }
+
+  public:
+    offline_writer() = default;
+    offline_writer(const offline_writer&) = delete;
+    offline_writer& operator=(const offline_writer&) = delete;
+    ~offline_writer()
+    { close(); }
+
+    bool open(const std::string& directory, offline_format format)
+    {
+      close();
+      std::error_code error;
+      std::filesystem::create_directories(directory, error);
+      if (error)
+      { return false; }
+
+      directory_ = directory;
+      format_    = format;
+      if (format_ == offline_format::npz)
+      {
+        zip_ = std::fopen((directory_/"session.npz").string().c_str(), "wb");
+        if (zip_ == nullptr)
+        { return false; }
+        std::setvbuf(zip_, nullptr, _IOFBF, 1u << 22u);
+        zip_offset_ = 0u;
+        zip_entries_.clear();
+      }
+      created_call_.clear();
+      n_calls_  = 0u;
+      start_    = now_ns();
+      running_  = true;
+      open_     = true;
+      thread_   = std::thread(&offline_writer::run, this);
+      return true;
+    }
+
+    // writes the pending files (and the npz central directory)
+    void close()
+    {
+      if (!open_)
+      { return; }
+      finish_call();
+      {
+        std::lock_guard<std::mutex> lock(lock_);
+        running_ = false;
+      }
+      work_.notify_one();
+      thread_.join();
+      if (zip_ != nullptr)
+      {
+        finish_zip();
+        std::fclose(zip_);
+        zip_ = nullptr;
+      }
+      open_ = false;
+    }
+
+    bool is_open() const noexcept
+    { return open_; }
+
+    void begin_message()
+    {
+      finish_call();
+      char call[32];
+      std::snprintf(call, sizeof(call), "call_%06llu", static_cast<unsigned long long>(n_calls_++));
+      call_         = call;
+      header_lines_ = "# t=" + std::to_string(now_ns() - start_) + "\n";
+      call_started_ = true;
+    }
+
+    void write(const zmq::message_t& frame, bool payload)
+    {
+      if (!call_started_)
+      { begin_message(); }
+      const char * data = static_cast<const char*>(frame.data());
+      const std::size_t size = frame.size();
+
+      if (!payload)
+      {
+        const std::string text(data, size);
+        if (text.rfind("data|", 0u) == 0u)
+        {
+          // data|name|dtype|n|shape|encoding|frames
+          fields_ = split(text, '|');
+          fields_.resize(7u, "");
+          frame_  = 0u;
+          const std::string stem = file_stem(fields_[1]);
+          const bool plain = (fields_[5] == "raw") || fields_[5].empty();
+          const std::string file = !plain ? (stem + "." + fields_[5].substr(0u, fields_[5].find(':')))
+                                          : (fields_[2] == "c") ? (stem + ".txt") : (stem + ".npy");
+          header_lines_ += file + "\t" + text + "\n";
+        }
+        else if (text != "finalize")
+        { enqueue("script.py", "", data, size); }
+        return;
+      }
+
+      const std::string stem = file_stem(fields_[1]);
+      if ((fields_[5] != "raw") && !fields_[5].empty())
+      { enqueue(stem + "." + fields_[5].substr(0u, fields_[5].find(':')) + "." + std::to_string(frame_) + ".bin", "", data, size); }
+      else if (fields_[2] == "c")
+      { enqueue(stem + ".txt", "", data, size); }
+      else
+      {
+        // scalars are sent with shape (0,)
+        enqueue(stem + ".npy", npy_header(fields_[2], (fields_[4] == "(0,)") ? std::string("()") : fields_[4]), data, size);
+      }
+      frame_++;
+    }
+};
+
+inline offline_writer& offline()
+{
+  static offline_writer writer;
+  return writer;
+}
+
+// the next frames form a new message (pyp.raw call, watch batch, ...), for the session log, the offline capture and the fidelity level
+inline void begin_message()
+{
+  recorder().begin_message();
+  fidelity().begin_message();
+  if (offline().is_open())
+  { offline().begin_message(); }
+}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef _CPPYPLOT_PARALLEL_H_
+#define _CPPYPLOT_PARALLEL_H_
+
+/* number of worker threads used by the C++ side kernels (downscaling, binning, ...) */
+inline std::size_t& parallel_threads()
+{
+  static std::size_t n_threads = std::max(1u, std::thread::hardware_concurrency());
+  return n_threads;
+}
+
+/*
+  * splits [begin, end) into contiguous chunks of at least min_chunk items and 
+  * runs func(chunk_begin, chunk_end) on each of them, the first chunk runs on the calling thread
+*/
+template<typename Func>
+void parallel_for(std::size_t begin, std::size_t end, Func&& func, std::size_t min_chunk = 1u)
+{
+  if (end <= begin)
+  { return; }
+
+  const std::size_t n_items   = end - begin;
+  const std::size_t n_workers = std::min(parallel_threads(), std::max<std::size_t>(1u, n_items/std::max<std::size_t>(min_chunk, 1u)));
+  if (n_workers <= 1u)
+  { 
+    func(begin, end);
+    return;
+  }
+
+  const std::size_t chunk = (n_items + n_workers - 1u)/n_workers;
+  std::vector<std::thread> workers;
+  workers.reserve(n_workers - 1u);
+  for (std::size_t chunk_begin = begin + chunk; chunk_begin < end; chunk_begin += chunk)
+  { workers.emplace_back(func, chunk_begin, std::min(end, chunk_begin + chunk)); }
+
+  func(begin, std::min(end, begin + chunk));
+  for (auto& worker : workers)
+  { worker.join(); }
+}
+
+#endif
@@ -0,0 +1,260 @@
+#ifndef _CPPYPLOT_POINTS_H_
+#define _CPPYPLOT_POINTS_H_
+
+/*
+  * Point cloud downsampling of N x 3 containers (x, y, z per row) before sending
+  * voxel : points are hashed into cubic voxels of edge 'voxel_size', one centroid is sent per occupied voxel,
+  *         columns after x, y, z (intensity, r, g, b, ...) are averaged per voxel as well.
+  * random: uniformly random subset of the rows (all columns kept), deterministic for a given input size.
+  * _point_budget picks the voxel size (or subset size) so that at most 'max_points' rows are sent
+  * (max_points/2^level under server backpressure, see cppyplot_fidelity.h).
+  * Python side gets a plain (n, columns) float64 array, ready for ax.scatter(p[:,0], p[:,1], p[:,2]).
+  * Fixed size rows with less than 3 columns do not compile, runtime sized ones are sent as an empty array.
+*/
+enum class point_sampling { voxel, random };
+
+// columns of containers with fixed size rows, 0 when the row size is only known at runtime (checked by sample_dims)
+template<typename T>
+struct point_columns{ static constexpr std::size_t value = 0u; };
+
+template<typename T>
+struct point_columns<std::vector<T>>{ static constexpr std::size_t value = std::is_arithmetic_v<T> ? 1u : 0u; };
+
+template<typename T, std::size_t N>
+struct point_columns<std::array<T, N>>{ static constexpr std::size_t value = std::is_arithmetic_v<T> ? 1u : 0u; };
+
+template<typename T, std::size_t M>
+struct point_columns<std::vector<std::array<T, M>>>{ static constexpr std::size_t value = M; };
+
+template<typename T, std::size_t N, std::size_t M>
+struct point_columns<std::array<std::array<T, M>, N>>{ static constexpr std::size_t value = M; };
+
+template<typename T>
+struct downsampled_points{
+  static_assert((point_columns<std::remove_cv_t<T>>::value == 0u) || (point_columns<std::remove_cv_t<T>>::value >= 3u), 
+                "point clouds need N x 3 containers (x, y, z per row)");
+  using value_type = double;
+  const T&       data;
+  double         voxel_size;
+  std::size_t    max_points;
+  point_sampling method;
+  // rows are computed once, header (shape) and payload are created from the same result
+  mutable std::shared_ptr<std::vector<double>> rows;
+};
+
+template<typename T>
+inline auto _voxel_grid(std::pair<std::string, T&>&& arg, double voxel_size)
+{ return std::make_pair(arg.first, downsampled_points<T>{arg.second, voxel_size, 0u, point_sampling::voxel, nullptr}); }
+
+template<typename T>
+inline auto _point_budget(std::pair<std::string, T&>&& arg, std::size_t max_points,
+                          point_sampling method = point_sampling::voxel)
+{ return std::make_pair(arg.first, downsampled_points<T>{arg.second, 0.0, std::max<std::size_t>(max_points/fidelity().decimation(), 1u), method, nullptr}); }
+
+/*
+  * Per voxel centroids of all columns, voxels are accumulated per chunk in parallel
+  * and merged in chunk order so the output does not depend on thread scheduling.
+  * Voxel of every point is packed into 21 bits per axis, non finite points are skipped.
+*/
+template<typename T>
+std::vector<double> voxel_centroids(const T& data, double voxel_size, const std::array<double, 3>& origin)
+{
+  const std::size_t n_cols = sample_dims(data);
+  const std::size_t stride = n_cols + 1u;   // column sums and point count
+  if (n_cols < 3u)
+  { return std::vector<double>{}; }
+
+  struct voxel_map{
+    std::unordered_map<std::uint64_t, std::size_t> slot;
+    std::vector<std::uint64_t> keys;
+    std::vector<double> sums;
+  };
+  std::map<std::size_t, voxel_map> chunks;
+  std::mutex chunks_lock;
+
+  parallel_for(0u, sample_count(data), [&](std::size_t begin, std::size_t end)
+  {
+    voxel_map local;
+    for (std::size_t i = begin; i < end; i++)
+    {
+      std::uint64_t key = 0u;
+      bool valid = true;
+      for (std::size_t d = 0u; d < 3u; d++)
+      {
+        const double cell = std::floor((sample_at(data, i, d) - origin[d])/voxel_size);
+        valid = valid && (cell >= 0.0) && (cell < 2097152.0);
+        key |= (valid ? static_cast<std::uint64_t>(cell) : 0u) << (21u*d);
+      }
+      if (!valid)
+      { continue; }
+
+      auto [it, inserted] = local.slot.try_emplace(key, local.keys.size());
+      if (inserted)
+      {
+        local.keys.push_back(key);
+        local.sums.resize(local.sums.size() + stride, 0.0);
+      }
+      double* sums = local.sums.data() + it->second*stride;
+      for (std::size_t c = 0u; c < n_cols; c++)
+      { sums[c] += sample_at(data, i, c); }
+      sums[n_cols] += 1.0;
+    }
+    std::lock_guard<std::mutex> lock(chunks_lock);
+    chunks.emplace(begin, std::move(local));
+  }, 1u << 16u);
+
+  voxel_map merged;
+  for (auto& [begin, chunk] : chunks)
+  {
+    (void)begin;
+    if (merged.keys.empty())
+    {
+      merged = std::move(chunk);
+      continue;
+    }
+    for (std::size_t v = 0u; v < chunk.keys.size(); v++)
+    {
+      auto [it, inserted] = merged.slot.try_emplace(chunk.keys[v], merged.keys.size());
+      if (inserted)
+      {
+        merged.keys.push_back(chunk.keys[v]);
+        merged.sums.resize(merged.sums.size() + stride, 0.0);
+      }
+      double* sums = merged.sums.data() + it->second*stride;
+      for (std::size_t c = 0u; c < stride; c++)
+      { sums[c] += chunk.sums[v*stride + c]; }
+    }
+  }
+
+  std::vector<double> centroids(merged.keys.size()*n_cols);
+  for (std::size_t v = 0u; v < merged.keys.size(); v++)
+  {
+    const double* sums = merged.sums.data() + v*stride;
+    for (std::size_t c = 0u; c < n_cols; c++)
+    { centroids[v*n_cols + c] = sums[c]/sums[n_cols]; }
+  }
+  return centroids;
+}
+
+/* selection sampling (Knuth's algorithm S), keeps 'n_keep' rows in their original order */
+template<typename T>
+std::vector<double> random_points(const T& data, std::size_t n_keep)
+{
+  const std::size_t n_rows = sample_count(data);
+  const std::size_t n_cols = sample_dims(data);
+  n_keep = std::min(n_keep, n_rows);
+
+  std::mt19937_64 gen(n_rows);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  std::vector<double> selected;
+  selected.reserve(n_keep*n_cols);
+  std::size_t n_selected = 0u;
+  for (std::size_t i = 0u; (i < n_rows) && (n_selected < n_keep); i++)
+  {
+    if (static_cast<double>(n_rows - i)*uniform(gen) < static_cast<double>(n_keep - n_selected))
+    {
+      for (std::size_t c = 0u; c < n_cols; c++)
+      { selected.push_back(sample_at(data, i, c)); }
+      n_selected++;
+    }
+  }
+  return selected;
+}
+
+template<typename T>
+const std::vector<double>& downsampled_rows(const downsampled_points<T>& data)
+{
+  if (data.rows)
+  { return *data.rows; }
+
+  // runtime sized rows with less than x, y, z, python side gets an empty array
+  if (sample_dims(data.data) < 3u)
+  {
+    data.rows = std::make_shared<std::vector<double>>();
+    return *data.rows;
+  }
+
+  const std::size_t n_rows = sample_count(data.data);
+  std::vector<double> rows;
+  if (data.method == point_sampling::random)
+  { rows = random_points(data.data, data.max_points); }
+  else
+  {
+    // voxel origin and size, at most 2^21 voxels per axis
+    std::array<double, 3> origin{};
+    double extent = 0.0, volume = 1.0;
+    for (std::size_t d = 0u; d < 3u; d++)
+    {
+      const auto [min_val, max_val] = sample_min_max(data.data, d);
+      origin[d] = min_val;
+      extent    = std::max(extent, max_val - min_val);
+      volume   *= std::max(max_val - min_val, 0.0);
+    }
+    const double min_voxel = std::max(extent/2097151.0, std::numeric_limits<double>::min());
+
+    if (data.max_points == 0u)
+    { rows = voxel_centroids(data.data, std::max(data.voxel_size, min_voxel), origin); }
+    else if (n_rows <= data.max_points)
+    { rows = random_points(data.data, n_rows); }
+    else
+    {
+      // occupied voxels n(s) ~ s^-k, k is 3 for volumes, 2 for surfaces and 1 for lines.
+      // start from the voxel size that splits the bounding box into max_points voxels, refine k from the 
+      // last two steps and aim at 95% of the budget, keep the largest result within the budget
+      const std::size_t n_cols = std::max<std::size_t>(sample_dims(data.data), 1u);
+      const double target = 0.95*static_cast<double>(data.max_points);
+      double voxel_size = (volume > 0.0) ? std::cbrt(volume/static_cast<double>(data.max_points))
+                                         : extent/std::cbrt(static_cast<double>(data.max_points));
+      voxel_size = std::max(voxel_size, min_voxel);
+      double exponent = 3.0;
+      std::vector<double> candidate = voxel_centroids(data.data, voxel_size, origin);
+      for (std::size_t iter = 0u; iter < 8u; iter++)
+      {
+        const double n_voxels = static_cast<double>(candidate.size()/n_cols);
+        if ((n_voxels <= static_cast<double>(data.max_points)) && (candidate.size() > rows.size()))
+        { rows = std::move(candidate); }
+        if ((n_voxels <= static_cast<double>(data.max_points)) && (n_voxels >= 0.9*static_cast<double>(data.max_points)))
+        { break; }
+
+        const double next_size = std::max(voxel_size*std::pow(std::max(n_voxels, 1.0)/target, 1.0/exponent), min_voxel);
+        candidate = voxel_centroids(data.data, next_size, origin);
+        const double next_voxels = static_cast<double>(candidate.size()/n_cols);
+        if ((next_voxels != n_voxels) && (next_size != voxel_size))
+        { exponent = std::clamp(std::log(std::max(n_voxels, 1.0)/std::max(next_voxels, 1.0))/std::log(next_size/voxel_size), 1.0, 3.0); }
+        voxel_size = next_size;
+      }
+      // 1.5^64 covers any finite extent, an empty candidate means no point is finite (NaN rows of organized clouds)
+      for (std::size_t grow = 0u; rows.empty() && (grow < 64u); grow++)
+      {
+        voxel_size *= 1.5;
+        candidate = voxel_centroids(data.data, voxel_size, origin);
+        if (candidate.empty())
+        { break; }
+        if (candidate.size()/n_cols <= data.max_points)
+        { rows = std::move(candidate); }
+      }
+    }
+  }
+  data.rows = std::make_shared<std::vector<double>>(std::move(rows));
+  return *data.rows;
+}
+
+template<typename T>
+inline std::array<std::size_t, 2> container_shape(const downsampled_points<T>& data)
+{
+  const std::size_t n_cols = std::max<std::size_t>(sample_dims(data.data), 1u);
+  return std::array<std::size_t, 2>{downsampled_rows(data).size()/n_cols, n_cols};
+}
+
+template<typename T>
+inline std::size_t container_size(const downsampled_points<T>& data)
+{ return downsampled_rows(data).size(); }
+
+template<typename T>
+inline void fill_zmq_buffer(const downsampled_points<T>& data, zmq::message_t& buffer)
+{
+  const auto& rows = downsampled_rows(data);
+  buffer.rebuild(rows.data(), rows.size()*sizeof(double));
+}
+
+#endif
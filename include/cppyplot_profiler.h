@@ -0,0 +1,276 @@
+#ifndef _CPPYPLOT_PROFILER_H_
+#define _CPPYPLOT_PROFILER_H_
+
+/*
+  * Scoped timer profiler: CPPYPLOT_SCOPE("name") records the begin/end time and nesting depth of the enclosing scope
+  * into a buffer of the calling thread (single producer ring, no locks and no allocation after the first scope of a thread).
+  * pyp.profile(name) enables recording and lets the background sampler send the recorded scopes in batches,
+  * python side accumulates them in a Profile with a per thread timeline() and an aggregated flame() graph.
+  * While disabled a scope costs one relaxed atomic load, a recorded scope two clock reads and one 32 byte store.
+  * On x86-64 the clock is the (invariant) time stamp counter, calibrated against steady_clock once (50ms) by pyp.profile().
+  * Names have to outlive the program (string literals), scopes that do not fit into a full buffer are counted as dropped.
+  * Defining CPPYPLOT_DISABLE_PROFILER compiles CPPYPLOT_SCOPE out.
+  * payload: names added since the last batch ('\n' separated) | scopes (begin, end (int64 ns), name (uint32), thread, depth (uint16))
+*/
+constexpr std::size_t PROFILE_BUFFER_SIZE = 1u << 14u;   // scopes per thread between two batches
+
+#if defined(_M_X64) || defined(__x86_64__)
+  #define CPPYPLOT_PROFILE_TSC
+#endif
+
+inline std::int64_t steady_ns() noexcept
+{ return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+
+// time stamp of scope boundaries, TSC ticks on x86-64 and steady_clock ns otherwise
+inline std::int64_t profile_clock() noexcept
+{
+#if defined(CPPYPLOT_PROFILE_TSC)
+  return static_cast<std::int64_t>(__rdtsc());
+#else
+  return steady_ns();
+#endif
+}
+
+struct profile_record{
+  const char *  name;
+  std::int64_t  begin;
+  std::int64_t  end;
+  std::uint32_t depth;
+};
+
+struct profile_buffer{
+  std::vector<profile_record> records = std::vector<profile_record>(PROFILE_BUFFER_SIZE);
+  std::atomic<std::uint64_t>  head{0u};      // written by the owning thread
+  std::atomic<std::uint64_t>  tail{0u};      // written by the sending thread
+  std::atomic<std::uint64_t>  dropped{0u};
+  std::uint32_t               depth = 0u;    // owning thread only
+  std::uint16_t               thread_index = 0u;
+};
+
+inline std::atomic<bool>& profiling_enabled() noexcept
+{
+  static std::atomic<bool> enabled{false};
+  return enabled;
+}
+
+inline void set_profiling(bool enable) noexcept
+{ profiling_enabled().store(enable, std::memory_order_relaxed); }
+
+/* buffers of every thread that recorded a scope, buffers of finished threads are released once they are sent */
+class profile_registry{
+  private:
+    std::mutex                                   lock_;
+    std::vector<std::shared_ptr<profile_buffer>> buffers_;
+    std::uint16_t                                next_thread_ = 0u;
+    std::uint64_t                                dropped_     = 0u;
+    std::once_flag                               calibrated_;
+    double                                       ns_per_tick_ = 1.0;
+    // name table, used by the sending thread only
+    std::unordered_map<const char*, std::uint32_t> name_ids_;
+    std::unordered_map<std::string, std::uint32_t> string_ids_;
+
+  public:
+    const std::int64_t epoch        = profile_clock();
+    const std::int64_t epoch_steady = steady_ns();
+
+    // ns per profile_clock tick, measured once over the first 50ms so that every batch is converted alike
+    double ns_per_tick()
+    {
+      std::call_once(calibrated_, [this]()
+      {
+#if defined(CPPYPLOT_PROFILE_TSC)
+        std::int64_t elapsed_ns = steady_ns() - epoch_steady;
+        if (elapsed_ns < 50'000'000)
+        {
+          std::this_thread::sleep_for(std::chrono::nanoseconds(50'000'000 - elapsed_ns));
+          elapsed_ns = steady_ns() - epoch_steady;
+        }
+        ns_per_tick_ = static_cast<double>(elapsed_ns)/static_cast<double>(std::max<std::int64_t>(profile_clock() - epoch, 1));
+#endif
+      });
+      return ns_per_tick_;
+    }
+
+    std::shared_ptr<profile_buffer> add_thread()
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      auto buffer = std::make_shared<profile_buffer>();
+      buffer->thread_index = next_thread_++;
+      buffers_.push_back(buffer);
+      return buffer;
+    }
+
+    bool pending()
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      return std::any_of(buffers_.begin(), buffers_.end(), [](const auto& buffer)
+                         { return buffer->head.load(std::memory_order_acquire) != buffer->tail.load(std::memory_order_relaxed); });
+    }
+
+    // id of 'name', names not seen before are appended to 'new_names'
+    std::uint32_t name_id(const char* name, std::string& new_names)
+    {
+      auto it = name_ids_.find(name);
+      if (it != name_ids_.end())
+      { return it->second; }
+
+      // the same literal may have different addresses in different translation units
+      auto [string_it, inserted] = string_ids_.try_emplace(name, static_cast<std::uint32_t>(string_ids_.size()));
+      if (inserted)
+      {
+        new_names += name;
+        new_names += '\n';
+      }
+      name_ids_.emplace(name, string_it->second);
+      return string_it->second;
+    }
+
+    std::uint32_t n_names() const noexcept
+    { return static_cast<std::uint32_t>(string_ids_.size()); }
+
+    // scopes dropped so far (all threads)
+    std::uint64_t dropped() const noexcept
+    { return dropped_; }
+
+    template<typename Func>
+    void drain(Func&& func)
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      for (const auto& buffer : buffers_)
+      {
+        func(*buffer);
+        dropped_ += buffer->dropped.exchange(0u, std::memory_order_relaxed);
+      }
+      buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(), [](const auto& buffer)
+                     { return (buffer.use_count() == 1) && (buffer->head.load(std::memory_order_acquire) == buffer->tail.load(std::memory_order_relaxed)); }),
+                     buffers_.end());
+    }
+};
+
+inline profile_registry& profiler()
+{
+  static profile_registry registry;
+  return registry;
+}
+
+inline profile_buffer& thread_profile_buffer()
+{
+  thread_local std::shared_ptr<profile_buffer> buffer = profiler().add_thread();
+  return *buffer;
+}
+
+class profile_scope{
+  private:
+    const char *     name_;
+    profile_buffer * buffer_ = nullptr;
+    std::uint32_t    depth_  = 0u;
+    std::int64_t     begin_  = 0;
+
+  public:
+    explicit profile_scope(const char* name) noexcept
+      : name_(name)
+    {
+      if (!profiling_enabled().load(std::memory_order_relaxed))
+      { return; }
+      buffer_ = &thread_profile_buffer();
+      depth_  = buffer_->depth++;
+      begin_  = profile_clock();
+    }
+
+    profile_scope(const profile_scope&) = delete;
+    profile_scope& operator=(const profile_scope&) = delete;
+
+    ~profile_scope()
+    {
+      if (buffer_ == nullptr)
+      { return; }
+      const std::int64_t end = profile_clock();
+      buffer_->depth--;
+
+      const std::uint64_t head = buffer_->head.load(std::memory_order_relaxed);
+      if ((head - buffer_->tail.load(std::memory_order_acquire)) < PROFILE_BUFFER_SIZE)
+      {
+        buffer_->records[static_cast<std::size_t>(head % PROFILE_BUFFER_SIZE)] = profile_record{name_, begin_, end, depth_};
+        buffer_->head.store(head + 1u, std::memory_order_release);
+      }
+      else
+      { buffer_->dropped.fetch_add(1u, std::memory_order_relaxed); }
+    }
+};
+
+struct profile_event{
+  std::int64_t  begin;   // ns since the profiler started
+  std::int64_t  end;
+  std::uint32_t name;
+  std::uint16_t thread;
+  std::uint16_t depth;
+};
+static_assert(sizeof(profile_event) == 24u, "profile events are sent as 3 x int64");
+
+/* scopes recorded since the last batch */
+struct profile_batch{
+  using value_type = std::int64_t;
+  std::uint32_t              first_name = 0u;
+  std::uint64_t              dropped    = 0u;
+  std::string                names;
+  std::vector<profile_event> events;
+};
+
+inline profile_batch take_profile()
+{
+  profile_registry& registry = profiler();
+  profile_batch batch;
+  batch.first_name = registry.n_names();
+  const double ns_per_tick = registry.ns_per_tick();
+  auto to_ns = [&](std::int64_t ticks){ return static_cast<std::int64_t>(static_cast<double>(ticks - registry.epoch)*ns_per_tick); };
+  registry.drain([&](profile_buffer& buffer)
+  {
+    const std::uint64_t tail = buffer.tail.load(std::memory_order_relaxed);
+    const std::uint64_t head = buffer.head.load(std::memory_order_acquire);
+    for (std::uint64_t i = tail; i < head; i++)
+    {
+      const profile_record& record = buffer.records[static_cast<std::size_t>(i % PROFILE_BUFFER_SIZE)];
+      batch.events.push_back(profile_event{to_ns(record.begin), to_ns(record.end),
+                                           registry.name_id(record.name, batch.names),
+                                           buffer.thread_index, static_cast<std::uint16_t>(record.depth)});
+    }
+    buffer.tail.store(head, std::memory_order_release);
+  });
+  batch.dropped = registry.dropped();
+  return batch;
+}
+
+inline std::size_t container_size(const profile_batch& data)
+{ return data.events.size()*3u; }
+
+inline std::array<std::size_t, 2> container_shape(const profile_batch& data)
+{ return std::array<std::size_t, 2>{data.events.size(), 3u}; }
+
+inline std::string container_encoding(const profile_batch& data)
+{ return "profile:" + std::to_string(data.first_name) + "," + std::to_string(data.dropped); }
+
+template<>
+struct container_frames<profile_batch> : std::integral_constant<std::size_t, 2u> {};
+
+inline void fill_zmq_buffer(const profile_batch& data, std::size_t frame, zmq::message_t& buffer)
+{
+  if (frame == 0u)
+  {
+    buffer.rebuild(data.names.data(), data.names.size());
+    return;
+  }
+  buffer.rebuild(data.events.size()*sizeof(profile_event));
+  if (!data.events.empty())
+  { std::memcpy(buffer.data(), data.events.data(), data.events.size()*sizeof(profile_event)); }
+}
+
+
+#define CPPYPLOT_CONCAT_IMPL(A, B) A##B
+#define CPPYPLOT_CONCAT(A, B) CPPYPLOT_CONCAT_IMPL(A, B)
+#if defined(CPPYPLOT_DISABLE_PROFILER)
+  #define CPPYPLOT_SCOPE(NAME) ((void)0)
+#else
+  #define CPPYPLOT_SCOPE(NAME) ::Cppyplot::profile_scope CPPYPLOT_CONCAT(cppyplot_scope_, __LINE__)(NAME)
+#endif
+
+#endif
@@ -0,0 +1,204 @@
+#ifndef _CPPYPLOT_RENDER_H_
+#define _CPPYPLOT_RENDER_H_
+
+/*
+  * Figures rendered by the server (Agg) and returned as RGBA framebuffers, for embedding plots in C++ GUIs (ImGui, Qt).
+  * In a plot script render.figure("chart", width, height) creates a figure without a window, render.attach(fig, "chart")
+  * returns an existing one. The server renders a figure only when it changed (at most every 1/120s) and publishes it
+  * on the return channel, through shared memory when the channel is local on posix hosts and otherwise inline in the message.
+  * Shared memory holds two slots per figure written alternately, every slot starts with a sequence word
+  * (2*sequence+1 while written, 2*sequence when complete) that is checked before and after a slot is copied.
+  * On this side every figure has a front and a spare frame, a new frame is copied into the spare (a new one when
+  * the spare is still referenced) and swapped with the front, cppyplot::rendered("chart") returns the front.
+  * message: frame_header | RGBA (inline)
+*/
+constexpr std::size_t RENDER_SEGMENT_NAME = 64u;
+
+enum class frame_transport : std::uint32_t { inline_pixels = 0u, shared_memory = 1u };
+
+struct frame_header{
+  std::uint64_t   sequence;                     // per figure, increments with every rendered frame
+  std::uint32_t   width;
+  std::uint32_t   height;
+  frame_transport transport;
+  std::uint32_t   reserved;
+  std::uint64_t   offset;                       // slot offset in the shared memory segment
+  char            name[24];                     // figure name given to render.figure/render.attach
+  char            segment[RENDER_SEGMENT_NAME]; // shared memory segment name (shared_memory transport)
+};
+static_assert(sizeof(frame_header) == 120u, "frame_header has to match the python struct '<QIIIIQ24s64s'");
+
+struct rendered_frame{
+  std::uint64_t             sequence = 0u;
+  std::uint32_t             width    = 0u;
+  std::uint32_t             height   = 0u;
+  std::vector<std::uint8_t> rgba;               // width*height*4 bytes, top row first
+};
+
+// read only mapping of a shared memory segment created by the server (posix, windows gets the frames inline)
+class shared_segment{
+  private:
+    std::string           name_;
+    const std::uint8_t *  data_ = nullptr;
+    std::size_t           size_ = 0u;
+
+  public:
+    shared_segment() = default;
+    shared_segment(const shared_segment&) = delete;
+    shared_segment& operator=(const shared_segment&) = delete;
+    ~shared_segment()
+    { close(); }
+
+    bool open(const std::string& name)
+    {
+      if ((data_ != nullptr) && (name == name_))
+      { return true; }
+      close();
+#if defined(CPPYPLOT_SHARED_FRAMES)
+      // python's multiprocessing.shared_memory prefixes posix names with '/'
+      const int fd = shm_open(("/" + name).c_str(), O_RDONLY, 0);
+      if (fd < 0)
+      { return false; }
+      struct stat info;
+      void * view = MAP_FAILED;
+      if ((fstat(fd, &info) == 0) && (info.st_size > 0))
+      { view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0); }
+      ::close(fd);
+      if (view == MAP_FAILED)
+      { return false; }
+      data_ = static_cast<const std::uint8_t*>(view);
+      size_ = static_cast<std::size_t>(info.st_size);
+      name_ = name;
+      return true;
+#else
+      return false;
+#endif
+    }
+
+    void close()
+    {
+#if defined(CPPYPLOT_SHARED_FRAMES)
+      if (data_ != nullptr)
+      { munmap(const_cast<std::uint8_t*>(data_), size_); }
+#endif
+      data_ = nullptr;
+      size_ = 0u;
+      name_.clear();
+    }
+
+    const std::uint8_t * data() const noexcept
+    { return data_; }
+
+    std::size_t size() const noexcept
+    { return size_; }
+};
+
+class frame_receiver{
+  private:
+    struct target{
+      std::shared_ptr<rendered_frame> front;
+      std::shared_ptr<rendered_frame> spare;
+      shared_segment                  segment;  // receiving thread only
+    };
+
+    std::mutex                              lock_;   // guards the front and spare frames
+    std::map<std::string, target>           targets_;
+    std::atomic<std::uint64_t>              received_{0u};
+    std::atomic<std::uint64_t>              skipped_{0u};
+
+    // slot copy guarded by the sequence word, false when the server wrote the slot meanwhile
+    static bool copy_slot(const shared_segment& segment, const frame_header& header, std::uint8_t * dst, std::size_t n_bytes)
+    {
+      if ((header.offset + sizeof(std::uint64_t) + n_bytes) > segment.size())
+      { return false; }
+      const std::uint8_t * slot = segment.data() + header.offset;
+      std::uint64_t before, after;
+      std::memcpy(&before, slot, sizeof(before));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      std::memcpy(dst, slot + sizeof(std::uint64_t), n_bytes);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      std::memcpy(&after, slot, sizeof(after));
+      return (before == 2u*header.sequence) && (after == before);
+    }
+
+    void receive(const char* data, std::size_t size)
+    {
+      if (size < sizeof(frame_header))
+      { return; }
+      frame_header header;
+      std::memcpy(&header, data, sizeof(header));
+      header.name[sizeof(header.name) - 1u]       = '\0';
+      header.segment[sizeof(header.segment) - 1u] = '\0';
+      const std::size_t n_bytes = std::size_t{4u}*header.width*header.height;
+
+      std::shared_ptr<rendered_frame> frame;
+      target * dst;
+      {
+        std::lock_guard<std::mutex> lock(lock_);
+        dst = &targets_[header.name];
+        // the spare is reused unless the application still holds it
+        frame = ((dst->spare != nullptr) && (dst->spare.use_count() == 1))? dst->spare : std::make_shared<rendered_frame>();
+        dst->spare.reset();
+      }
+      frame->rgba.resize(n_bytes);
+
+      bool copied = false;
+      if (header.transport == frame_transport::inline_pixels)
+      {
+        copied = (size == (sizeof(frame_header) + n_bytes));
+        if (copied)
+        { std::memcpy(frame->rgba.data(), data + sizeof(frame_header), n_bytes); }
+      }
+      else if (dst->segment.open(header.segment))
+      { copied = copy_slot(dst->segment, header, frame->rgba.data(), n_bytes); }
+
+      std::lock_guard<std::mutex> lock(lock_);
+      if (!copied)
+      {
+        dst->spare = std::move(frame);
+        skipped_.fetch_add(1u, std::memory_order_relaxed);
+        return;
+      }
+      frame->sequence = header.sequence;
+      frame->width    = header.width;
+      frame->height   = header.height;
+      dst->spare = std::move(dst->front);
+      dst->front = std::move(frame);
+      received_.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+  public:
+    // receives rendered frames over the return channel (opened at 'address' unless already open)
+    bool enable(const std::string& address)
+    {
+      server_channel().set_handler(channel_kind::frame, [this](const char* data, std::size_t size)
+      { receive(data, size); });
+      if (server_channel().open(address))
+      { return true; }
+      server_channel().set_handler(channel_kind::frame, nullptr);
+      return false;
+    }
+
+    // latest frame of the figure 'name', nullptr before the first one. The frame is not modified while it is held
+    std::shared_ptr<const rendered_frame> latest(const std::string& name)
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      const auto it = targets_.find(name);
+      return (it != targets_.end())? it->second.front : nullptr;
+    }
+
+    std::uint64_t received() const noexcept
+    { return received_.load(std::memory_order_relaxed); }
+
+    // frames overwritten by the server while copied (the next frame replaces them) or not readable
+    std::uint64_t skipped() const noexcept
+    { return skipped_.load(std::memory_order_relaxed); }
+};
+
+inline frame_receiver& rendered_frames()
+{
+  static frame_receiver receiver;
+  return receiver;
+}
+
+#endif
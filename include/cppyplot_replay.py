@@ -0,0 +1,220 @@
+"""
+Replays a session recorded with Cppyplot::cppyplot::record_session(path) (or an offline capture written with
+Cppyplot::cppyplot::set_offline(directory), a directory of calls or its session.npz) into cppyplot_server.py.
+
+usage: python cppyplot_replay.py session.rec|directory|session.npz [--speed 1 | --speed 4 | --speed max] [--start seconds] [--jump]
+                                             [--address tcp://127.0.0.1:5555] [--no-server] [--info]
+
+--start fast forwards (max speed) to the given time so that the plots have the same state as in the original session,
+--jump skips everything before it instead (seek through the index, plots only show what is sent after it).
+The log is memory mapped, frames are sent straight from the mapping.
+"""
+import argparse
+import mmap
+import os
+import struct
+import subprocess
+import sys
+import time
+import zipfile
+from bisect import bisect_right
+
+import zmq
+
+FRAME_HEADER  = struct.Struct("<qIIQ")   # time, flags, reserved, size
+PAYLOAD       = 1
+MESSAGE_START = 2
+
+class Session:
+    begin = 32
+
+    def __init__(self, path):
+        self.file = open(path, "rb")
+        self.data = mmap.mmap(self.file.fileno(), 0, access=mmap.ACCESS_READ)
+        magic, version, _, self.start_unix_ns, _ = struct.unpack_from("<8sIIqQ", self.data, 0)
+        if (magic != b"CPPYREC\0") or (version != 1):
+            raise ValueError(f"{path} is not a cppyplot session")
+        self.index = self.read_index(path + ".idx")
+
+    def read_index(self, path):
+        # (time, offset) of messages, rebuilt by scanning the log when the index file is missing
+        if os.path.exists(path):
+            with open(path, "rb") as index_file:
+                raw = index_file.read()
+            entries = [struct.unpack_from("<qQ", raw, pos) for pos in range(8, len(raw) - 15, 16)]
+        else:
+            entries = [(t, offset) for offset, t, flags, _ in self.frames(32) if (flags & MESSAGE_START)]
+        return [t for t, _ in entries], [offset for _, offset in entries]
+
+    def frames(self, offset):
+        # (offset, time, flags, payload view), stops at the end or at a frame cut short by a crash
+        view = memoryview(self.data)
+        while (offset + FRAME_HEADER.size) <= len(self.data):
+            t, flags, _, size = FRAME_HEADER.unpack_from(self.data, offset)
+            begin = offset + FRAME_HEADER.size
+            if (begin + size) > len(self.data):
+                return
+            yield offset, t, flags, view[begin:begin + size]
+            offset = begin + size + (-size % 8)
+
+    def seek(self, t):
+        # offset of the last indexed message at or before t
+        times, offsets = self.index
+        pos = bisect_right(times, t) - 1
+        return offsets[pos] if (pos >= 0) else 32
+
+    def info(self):
+        n_frames, n_bytes, n_messages, last_t = 0, 0, 0, 0
+        for _, t, flags, payload in self.frames(32):
+            n_frames   += 1
+            n_bytes    += len(payload)
+            n_messages += (not (flags & PAYLOAD)) and (bytes(payload[:8]) == b"finalize")
+            last_t      = t
+        start = time.strftime("%Y-%m-%d %H:%M:%S", time.localtime(self.start_unix_ns*1e-9))
+        print(f"recorded {start}, {last_t*1e-9:.3f} s, {n_frames} frames ({n_bytes/2**20:.1f} MiB), "
+              f"{n_messages} plot calls, {len(self.index[0])} index entries")
+
+class OfflineSession:
+    """ calls written by set_offline(), same interface as Session with the call number as offset """
+    begin = 0
+
+    def __init__(self, path):
+        if os.path.isdir(path) and not os.path.exists(os.path.join(path, "call_000000")) \
+           and os.path.exists(os.path.join(path, "session.npz")):
+            path = os.path.join(path, "session.npz")
+        if os.path.isdir(path):
+            self.archive = None
+            self.root    = path
+            names = os.listdir(path)
+        else:
+            self.archive = zipfile.ZipFile(path)
+            names = {name.split("/")[0] for name in self.archive.namelist()}
+        self.calls = sorted(name for name in names if name.startswith("call_"))
+        self.times = [self.call_headers(call)[0] for call in self.calls]
+        self.index = self.times, list(range(len(self.calls)))
+
+    def read(self, call, name):
+        if self.archive is not None:
+            member = f"{call}/{name}"
+            if member not in self.archive.NameToInfo:
+                return None
+            return self.archive.read(member)
+        path = os.path.join(self.root, call, name)
+        if not os.path.exists(path):
+            return None
+        with open(path, "rb") as file:
+            return file.read()
+
+    def call_headers(self, call):
+        # time and (file, wire header) of every container, headers.txt is written last (missing after a crash)
+        text = self.read(call, "headers.txt")
+        if text is None:
+            return 0, []
+        lines = text.decode().splitlines()
+        t = int(lines[0].partition("=")[2]) if lines and lines[0].startswith("# t=") else 0
+        return t, [tuple(line.split("\t", 1)) for line in lines[1:] if line]
+
+    @staticmethod
+    def npy_data(raw):
+        # array bytes after the .npy header (version 1.0: 2 byte header length, 2.0/3.0: 4 bytes)
+        major = raw[6]
+        if major == 1:
+            return memoryview(raw)[10 + struct.unpack_from("<H", raw, 8)[0]:]
+        return memoryview(raw)[12 + struct.unpack_from("<I", raw, 8)[0]:]
+
+    def frames(self, offset):
+        for n in range(offset, len(self.calls)):
+            call = self.calls[n]
+            t, headers = self.call_headers(call)
+            flags = MESSAGE_START
+            for file_name, header in headers:
+                yield n, t, flags, header.encode()
+                flags = 0
+                fields = header.split("|")
+                if file_name.endswith(".npy"):
+                    yield n, t, PAYLOAD, self.npy_data(self.read(call, file_name))
+                elif file_name.endswith(".txt"):
+                    yield n, t, PAYLOAD, self.read(call, file_name)
+                else:
+                    for frame in range(int(fields[6]) if (len(fields) > 6) and fields[6] else 1):
+                        yield n, t, PAYLOAD, self.read(call, f"{file_name}.{frame}.bin")
+            script = self.read(call, "script.py")
+            if script is not None:
+                yield n, t, flags, script
+                yield n, t, 0, b"finalize"
+
+    def seek(self, t):
+        pos = bisect_right(self.times, t) - 1
+        return max(pos, 0)
+
+    def info(self):
+        n_files, n_bytes = 0, 0
+        for call in self.calls:
+            _, headers = self.call_headers(call)
+            n_files += len(headers)
+        for _, _, flags, payload in self.frames(0):
+            n_bytes += len(payload) if (flags & PAYLOAD) else 0
+        last_t = self.times[-1] if self.times else 0
+        print(f"offline capture, {last_t*1e-9:.3f} s, {len(self.calls)} calls, {n_files} containers ({n_bytes/2**20:.1f} MiB)")
+
+def open_session(path):
+    if os.path.isdir(path) or zipfile.is_zipfile(path):
+        return OfflineSession(path)
+    return Session(path)
+
+def replay(session, socket, speed, start, jump):
+    start_ns = int(start*1e9)
+    offset   = session.seek(start_ns) if jump else session.begin
+    wall_origin, time_origin = None, None
+    skipping = jump
+    for _, t, flags, payload in session.frames(offset):
+        # whole messages are skipped, a message sent before the start time is not sent partially
+        if (flags & MESSAGE_START):
+            skipping = jump and (t < start_ns)
+        if skipping:
+            continue
+        if (t >= start_ns) and (speed is not None):
+            if (wall_origin is None):
+                wall_origin, time_origin = time.monotonic(), t
+            delay = wall_origin + (t - time_origin)*1e-9/speed - time.monotonic()
+            if (delay > 0.0):
+                time.sleep(delay)
+        socket.send(payload, copy=False)
+
+def main():
+    parser = argparse.ArgumentParser(description="replay a recorded cppyplot session")
+    parser.add_argument("session")
+    parser.add_argument("--speed",     default="1",   help="replay speed factor or 'max'")
+    parser.add_argument("--start",     default=0.0,   type=float, help="time (s) to start the paced replay at")
+    parser.add_argument("--jump",      action="store_true", help="skip everything before --start instead of fast forwarding")
+    parser.add_argument("--address",   default="tcp://127.0.0.1:5555")
+    parser.add_argument("--python",    default=sys.executable, help="python used to spawn the server")
+    parser.add_argument("--no-server", action="store_true", help="do not spawn cppyplot_server.py (already running)")
+    parser.add_argument("--info",      action="store_true", help="print a summary of the session and exit")
+    args = parser.parse_args()
+
+    session = open_session(args.session)
+    if args.info:
+        session.info()
+        return
+
+    context = zmq.Context()
+    socket  = context.socket(zmq.PUB)
+    socket.bind(args.address)
+    time.sleep(0.1)
+    if not args.no_server:
+        server = os.path.join(os.path.dirname(os.path.abspath(__file__)), "cppyplot_server.py")
+        subprocess.Popen([args.python, server, args.address])
+        time.sleep(1.5)
+
+    speed = None if (args.speed == "max") else float(args.speed)
+    try:
+        replay(session, socket, speed, args.start, args.jump)
+    except KeyboardInterrupt:
+        pass
+    socket.send(b"exit")
+    socket.close(linger=1000)
+    context.term()
+
+if __name__ == "__main__":
+    main()
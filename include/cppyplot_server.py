@@ -1,8 +1,17 @@
 import zmq
 import sys
+import os
 
 from threading import Thread
 import struct
+import time
+
+## --restore <checkpoint directory> restores a checkpoint before the first plot call (Cppyplot::cppyplot::set_restore)
+restore_path = None
+if ("--restore" in sys.argv[:-1]):
+    restore_idx  = sys.argv.index("--restore")
+    restore_path = sys.argv[restore_idx + 1]
+    del sys.argv[restore_idx:restore_idx + 2]
 
 context = zmq.Context()
 socket = context.socket(zmq.SUB)
@@ -20,12 +29,38 @@ import queue
 msg_queue   = queue.Queue()
 kill_thread = False
 
+## return channel to C++, published to the address given as 2nd argument, message: kind (uint32) | payload
+## kind 0: backpressure status for adaptive fidelity (Cppyplot::cppyplot::set_adaptive):
+##         plot calls received and not evaluated yet, queued frames, evaluated calls, mean eval time (s)
+## kind 1: GUI event (Cppyplot::cppyplot::enable_events), see Events
+## kind 2: rendered figure (Cppyplot::cppyplot::enable_render), see Render
+CHANNEL_STATUS = 0
+CHANNEL_EVENT  = 1
+CHANNEL_FRAME  = 2
+channel = None
+if (len(sys.argv) > 2):
+    channel = context.socket(zmq.PUB)
+    channel.setsockopt(zmq.LINGER, 0)
+    channel.connect(sys.argv[2])
+STATUS_INTERVAL = 0.05
+calls_received  = 0
+calls_done      = 0
+eval_time       = 0.0
+last_status     = 0.0
+
+def publish_status(now):
+    global last_status
+    if (channel is not None) and ((now - last_status) >= STATUS_INTERVAL):
+        channel.send(struct.pack("<IQQQd", CHANNEL_STATUS, calls_received - calls_done, msg_queue.qsize(), calls_done, eval_time))
+        last_status = now
+
 def subscriber():
-    global socket, msg_queue
+    global socket, msg_queue, calls_received
     while (not kill_thread):
         if (socket.poll(50, zmq.POLLIN)):
             zmq_message = socket.recv()
             msg_queue.put(zmq_message)
+            calls_received += (zmq_message == b"finalize")
 
 subscriber_thread = Thread(target=subscriber)
 subscriber_thread.start()
@@ -39,7 +74,232 @@ lib_sym['np'] = np
 
 ## Import matplotlib and register plot object in the symbol table
 import matplotlib.pyplot as plt
+from matplotlib.image import AxesImage
+from matplotlib.backend_bases import MouseButton
+from matplotlib.widgets import Slider, RangeSlider, Button, CheckButtons, RadioButtons, TextBox
+from matplotlib._pylab_helpers import Gcf
 lib_sym['plt'] = plt
+lib_sym['MouseButton']  = MouseButton
+lib_sym['Slider']       = Slider
+lib_sym['RangeSlider']  = RangeSlider
+lib_sym['Button']       = Button
+lib_sym['CheckButtons'] = CheckButtons
+lib_sym['RadioButtons'] = RadioButtons
+lib_sym['TextBox']      = TextBox
+
+## GUI events to C++ (Cppyplot::plot_event): type, figure, axes, button, index, x, y, value, name
+## events.connect(fig) forwards clicks, key presses, scrolls and picks (artists created with picker=...),
+## events.widget(w, "name") the value changes of a widget
+class Events:
+    CLICK, RELEASE, KEY, SCROLL, PICK, WIDGET = range(6)
+    EVENT = struct.Struct("<IIiiqddd24s")
+    PUMP_INTERVAL = 0.001
+
+    def __init__(self):
+        self.active    = False
+        self.figures   = set()
+        self.widgets   = []
+        self.last_pump = 0.0
+
+    def send(self, kind, figure, axes=-1, button=0, index=-1, x=np.nan, y=np.nan, value=np.nan, name=""):
+        if (channel is None):
+            return
+        figure = getattr(figure, "number", 0) if (figure is not None) else 0
+        name   = str(name).encode("utf-8")[:23]
+        channel.send(struct.pack("<I", CHANNEL_EVENT) + self.EVENT.pack(kind, figure, axes, int(button), int(index), x, y, value, name))
+
+    @staticmethod
+    def coords(event):
+        fig  = event.canvas.figure
+        axes = fig.axes.index(event.inaxes) if (event.inaxes in fig.axes) else -1
+        x    = event.xdata if (event.xdata is not None) else np.nan
+        y    = event.ydata if (event.ydata is not None) else np.nan
+        return fig, axes, x, y
+
+    def on_mouse(self, kind, event):
+        fig, axes, x, y = self.coords(event)
+        button = int(event.button) if (event.button is not None) else 0
+        self.send(kind, fig, axes, button, -1, x, y)
+
+    def on_key(self, event):
+        fig, axes, x, y = self.coords(event)
+        self.send(self.KEY, fig, axes, 0, -1, x, y, name=event.key or "")
+
+    def on_scroll(self, event):
+        fig, axes, x, y = self.coords(event)
+        self.send(self.SCROLL, fig, axes, int(round(event.step)), -1, x, y, event.step)
+
+    def on_pick(self, event):
+        fig, axes, x, y = self.coords(event.mouseevent)
+        ind   = getattr(event, "ind", None)
+        index = int(ind[0]) if ((ind is not None) and (len(ind) > 0)) else -1
+        self.send(self.PICK, fig, axes, int(event.mouseevent.button or 0), index, x, y, name=event.artist.get_label())
+
+    def connect(self, fig=None):
+        fig = plt.gcf() if (fig is None) else fig
+        if (id(fig) in self.figures):
+            return fig
+        self.figures.add(id(fig))
+        canvas = fig.canvas
+        canvas.mpl_connect("button_press_event",   lambda e: self.on_mouse(self.CLICK, e))
+        canvas.mpl_connect("button_release_event", lambda e: self.on_mouse(self.RELEASE, e))
+        canvas.mpl_connect("key_press_event",      self.on_key)
+        canvas.mpl_connect("scroll_event",         self.on_scroll)
+        canvas.mpl_connect("pick_event",           self.on_pick)
+        self.active = True
+        return fig
+
+    def widget(self, w, name):
+        fig = w.ax.figure
+        if isinstance(w, RangeSlider):
+            w.on_changed(lambda val: self.send(self.WIDGET, fig, x=float(val[0]), y=float(val[1]), name=name))
+        elif isinstance(w, Slider):
+            w.on_changed(lambda val: self.send(self.WIDGET, fig, value=float(val), name=name))
+        elif isinstance(w, CheckButtons):
+            def checked(label):
+                labels = [text.get_text() for text in w.labels]
+                index  = labels.index(label) if (label in labels) else -1
+                self.send(self.WIDGET, fig, index=index, value=float(w.get_status()[index]) if (index >= 0) else np.nan, name=name)
+            w.on_clicked(checked)
+        elif isinstance(w, RadioButtons):
+            def selected(label):
+                labels = [text.get_text() for text in w.labels]
+                index  = labels.index(label) if (label in labels) else -1
+                self.send(self.WIDGET, fig, index=index, value=float(index), name=name)
+            w.on_clicked(selected)
+        elif isinstance(w, TextBox):
+            def submitted(text):
+                try:
+                    value = float(text)
+                except ValueError:
+                    value = np.nan
+                self.send(self.WIDGET, fig, value=value, name=name)
+            w.on_submit(submitted)
+        elif isinstance(w, Button):
+            w.on_clicked(lambda e: self.send(self.WIDGET, fig, value=1.0, name=name))
+        # widgets stop responding once they are garbage collected
+        self.widgets.append(w)
+        self.active = True
+        return w
+
+    def pump(self, now):
+        # runs the GUI event loop of the open figures while waiting for plot calls
+        if self.active and ((now - self.last_pump) >= self.PUMP_INTERVAL):
+            self.last_pump = now
+            for manager in Gcf.get_all_fig_managers():
+                manager.canvas.flush_events()
+
+events = Events()
+lib_sym['events'] = events
+
+## figures rendered with Agg and returned to C++ (Cppyplot::rendered_frame) for embedding in C++ GUIs.
+## render.figure("chart", width, height) creates a figure without a window, render.attach(fig, "chart") returns an existing one.
+## A figure is rendered when it changed, at most every RENDER_INTERVAL. Local channels on posix get the pixels through shared memory:
+## two slots of [sequence word | RGBA] written alternately, the word is 2*sequence+1 while a slot is written, 2*sequence after.
+from matplotlib.figure import Figure
+from matplotlib.backends.backend_agg import FigureCanvasAgg
+try:
+    from multiprocessing import shared_memory
+except ImportError:
+    shared_memory = None
+
+class Render:
+    FRAME  = struct.Struct("<QIIIIQ24s64s")
+    INLINE, SHARED = range(2)
+    RENDER_INTERVAL = 1.0/120.0
+
+    class Target:
+        def __init__(self, fig, name):
+            self.fig      = fig
+            self.name     = name
+            self.sequence = 0
+            self.dirty    = True
+            self.last     = 0.0
+            self.shm      = None
+            self.capacity = 0
+
+    def __init__(self):
+        self.targets = {}
+        self.segments = 0
+        address = sys.argv[2] if (len(sys.argv) > 2) else ""
+        # the C++ side maps posix shared memory only, windows gets the pixels inline
+        self.shared = (shared_memory is not None) and (os.name == "posix") and \
+                      (address.startswith(("ipc://", "tcp://127.0.0.1:", "tcp://localhost:")))
+
+    def figure(self, name, width=640, height=480, dpi=100):
+        fig = Figure(figsize=(width/dpi, height/dpi), dpi=dpi)
+        FigureCanvasAgg(fig)
+        return self.attach(fig, name)
+
+    def attach(self, fig, name):
+        if not hasattr(fig.canvas, "buffer_rgba"):
+            FigureCanvasAgg(fig)
+        target = self.Target(fig, name)
+        # every artist change marks the figure stale, the auto draw of interactive figures clears it again
+        previous = fig.stale_callback
+        def stale(figure, value):
+            target.dirty = target.dirty or value
+            if previous is not None:
+                previous(figure, value)
+        fig.stale_callback = stale
+        self.detach(name)
+        self.targets[name] = target
+        return fig
+
+    def detach(self, name):
+        target = self.targets.pop(name, None)
+        if (target is not None) and (target.shm is not None):
+            target.shm.close()
+            target.shm.unlink()
+
+    def segment(self, target, n_bytes):
+        if (target.shm is not None) and (target.capacity >= n_bytes):
+            return target.shm
+        if target.shm is not None:
+            target.shm.close()
+            target.shm.unlink()
+        # C++ maps a new segment when its name changes
+        self.segments += 1
+        target.capacity = n_bytes
+        target.shm      = shared_memory.SharedMemory(name="cppyplot_%d_%d" % (os.getpid(), self.segments),
+                                                     create=True, size=2*(8 + n_bytes))
+        return target.shm
+
+    def send(self, target):
+        canvas = target.fig.canvas
+        canvas.draw()
+        pixels = np.asarray(canvas.buffer_rgba())
+        height, width = pixels.shape[0], pixels.shape[1]
+        target.sequence += 1
+        target.dirty     = False
+        name = target.name.encode("utf-8")[:23]
+        if self.shared:
+            shm    = self.segment(target, pixels.nbytes)
+            offset = (target.sequence % 2)*(8 + target.capacity)
+            struct.pack_into("<Q", shm.buf, offset, 2*target.sequence + 1)
+            np.frombuffer(shm.buf, dtype=np.uint8, count=pixels.nbytes, offset=offset + 8)[:] = pixels.reshape(-1)
+            struct.pack_into("<Q", shm.buf, offset, 2*target.sequence)
+            header = self.FRAME.pack(target.sequence, width, height, self.SHARED, 0, offset, name, shm.name.encode("utf-8"))
+            channel.send(struct.pack("<I", CHANNEL_FRAME) + header)
+        else:
+            header = self.FRAME.pack(target.sequence, width, height, self.INLINE, 0, 0, name, b"")
+            channel.send(struct.pack("<I", CHANNEL_FRAME) + header + pixels.tobytes())
+
+    def update(self, now):
+        if channel is None:
+            return
+        for target in self.targets.values():
+            if target.dirty and ((now - target.last) >= self.RENDER_INTERVAL):
+                target.last = now
+                self.send(target)
+
+    def close(self):
+        for name in list(self.targets):
+            self.detach(name)
+
+render = Render()
+lib_sym['render'] = render
+lib_sym['Figure'] = Figure
 
 # from matplotlib.animation import FuncAnimation
 # lib_sym['FuncAnimation'] = FuncAnimation
@@ -70,10 +330,111 @@ aeval.symtable = make_symbol_table(use_numpy=True, **lib_sym)
 plot_cmd  = None
 plot_data = {}
 
+## checkpoints of the symbols added by plot calls (data, history lists, figures and their artists, derived arrays),
+## written by "checkpoint|<directory>" and restored by "restore|<directory>" or --restore. Numpy arrays of CHECKPOINT_NPY_MIN
+## bytes and more are .npy blocks restored memory mapped (copy on write), everything else is pickled in one state.pkl so
+## shared references (a line and its figure) survive. Symbols that cannot be pickled (modules, widgets, ...) are skipped.
+## <directory>/latest names the newest complete checkpoint_<n>, older ones are removed.
+import pickle
+import shutil
+import types
+
+CHECKPOINT_NPY_MIN = 4096
+base_symbols = set(aeval.symtable)
+
+class CheckpointPickler(pickle.Pickler):
+    def __init__(self, file, directory=None):
+        super().__init__(file, protocol=pickle.HIGHEST_PROTOCOL)
+        self.directory = directory
+        self.saved     = {}
+        self.keep      = []
+
+    def persistent_id(self, obj):
+        if (type(obj) not in (np.ndarray, np.memmap)) or (obj.dtype.hasobject) or (obj.nbytes < CHECKPOINT_NPY_MIN):
+            return None
+        key = self.saved.get(id(obj))
+        if key is None:
+            key = "%06d.npy" % len(self.saved)
+            self.saved[id(obj)] = key
+            self.keep.append(obj)
+            if self.directory is not None:
+                np.save(os.path.join(self.directory, key), obj, allow_pickle=False)
+        return key
+
+class CheckpointUnpickler(pickle.Unpickler):
+    def __init__(self, file, directory):
+        super().__init__(file)
+        self.directory = directory
+        self.loaded    = {}
+
+    def persistent_load(self, key):
+        if key not in self.loaded:
+            self.loaded[key] = np.load(os.path.join(self.directory, key), mmap_mode="c")
+        return self.loaded[key]
+
+class NullSink:
+    def write(self, data):
+        return len(data)
+
+def checkpoint(directory):
+    start   = time.monotonic()
+    symbols = {}
+    skipped = []
+    for name, value in aeval.symtable.items():
+        if (name in base_symbols) or isinstance(value, types.ModuleType):
+            continue
+        try:
+            CheckpointPickler(NullSink()).dump(value)
+            symbols[name] = value
+        except Exception:
+            skipped.append(name)
+
+    os.makedirs(directory, exist_ok=True)
+    latest  = os.path.join(directory, "latest")
+    current = open(latest).read().strip() if os.path.exists(latest) else None
+    version = "checkpoint_%d" % (int(current.rpartition("_")[2]) + 1 if current else 0)
+    target  = os.path.join(directory, version)
+    shutil.rmtree(target, ignore_errors=True)
+    os.makedirs(target)
+    with open(os.path.join(target, "state.pkl"), "wb") as state:
+        pickler = CheckpointPickler(state, target)
+        pickler.dump(symbols)
+    with open(latest + ".tmp", "w") as f:
+        f.write(version)
+    os.replace(latest + ".tmp", latest)
+    # restored arrays may still map the previous checkpoint (windows keeps mapped files)
+    for entry in os.listdir(directory):
+        if entry.startswith("checkpoint_") and (entry != version):
+            shutil.rmtree(os.path.join(directory, entry), ignore_errors=True)
+    print("[INFO] Checkpoint %s: %d symbols, %d arrays in %.2fs%s" % (target, len(symbols), len(pickler.saved), time.monotonic() - start,
+          (", skipped " + ", ".join(skipped)) if skipped else ""))
+
+def restore(directory):
+    start  = time.monotonic()
+    latest = os.path.join(directory, "latest")
+    if not os.path.exists(latest):
+        print("[INFO] No checkpoint in %s" % directory)
+        return
+    target = os.path.join(directory, open(latest).read().strip())
+    with open(os.path.join(target, "state.pkl"), "rb") as state:
+        symbols = CheckpointUnpickler(state, target).load()
+    aeval.symtable = {**aeval.symtable, **symbols}
+    for manager in Gcf.get_all_fig_managers():
+        manager.canvas.draw_idle()
+    print("[INFO] Restored %s: %d symbols in %.2fs" % (target, len(symbols), time.monotonic() - start))
+
+if restore_path is not None:
+    try:
+        restore(restore_path)
+    except Exception as e:
+        print("[Error] Restore failed: %s" % e)
+
 SYM_IDX   = 1
 TYPE_IDX  = 2
 LEN_IDX   = 3
 SHAPE_IDX = 4
+ENC_IDX   = 5
+FRAMES_IDX = 6
 
 print("[INFO] Plotting server initialized ...")
 
@@ -90,15 +451,816 @@ def parse_shape(shape_str:str)->tuple:
     
     return tuple(shape)
 
-def handle_payload(data, data_type, data_len, data_shape):
-    if ((data_type == 'c') or (data_type == 'b') or (data_type == 'B')):
+# element types that python struct understands, everything else (complex, half, datetime) goes through numpy
+STRUCT_TYPES = "cbB?hHiIlLqQfd"
+
+def handle_payload(data, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    if (data_type == 'c'):
         data_converted = struct.unpack("="+(data_type*data_len), data)
         return (b''.join(data_converted)).decode("utf-8")
     else:
-        if data_shape[0] > 0:
+        # scalars are sent with shape (0,), empty containers have no payload
+        if (data_shape[0] > 0) or (len(data_shape) > 1) or (len(data) == 0):
             return np.ndarray(data_shape, dtype="="+data_type, buffer=data)
-        else:
+        elif data_type in STRUCT_TYPES:
             return (struct.unpack("="+data_type, data))[0]
+        else:
+            return np.frombuffer(data, dtype="="+data_type)[0]
+
+def handle_bits(data, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    bits = np.unpackbits(np.frombuffer(data, dtype=np.uint8), count=data_len, bitorder="little")
+    return bits.astype(bool).reshape(data_shape)
+
+def handle_arange(data, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    dtype  = np.dtype("="+data_type)
+    axis_t = np.int64 if dtype.kind in "iu" else np.float64
+    start, step = np.frombuffer(data, dtype=axis_t)
+    return (start + step*np.arange(data_len, dtype=axis_t)).astype(dtype).reshape(data_shape)
+
+def handle_memmap(data, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    # out-of-core array, only the path is sent, pages are read when the plot script touches them
+    if (data_len == 0):
+        return np.zeros(data_shape, dtype="="+data_type)
+    return np.memmap(bytes(data).decode("utf-8"), dtype="="+data_type, mode="r", offset=int(enc_args[0]), shape=data_shape)
+
+def handle_fidelity(data, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    # every enc_args[0]-th row, sent as dtype enc_args[1] (float32/float16) while the server lags
+    return np.frombuffer(data, dtype="="+enc_args[1]).reshape(data_shape)
+
+# delta-of-delta bit width per gorilla code, has to match GORILLA_DOD_BITS in cppyplot_encoding.h
+GORILLA_DOD_BITS = np.array([0, 8, 24, 64], dtype=np.uint64)
+
+def extract_bits(stream, offsets, lengths):
+    # read 'lengths' bits (1..64) starting at bit 'offsets' of a MSB first stream, vectorized over all fields
+    padded   = np.concatenate((stream, np.zeros(9, dtype=np.uint8)))
+    words    = np.lib.stride_tricks.as_strided(padded, shape=(len(padded) - 8, 8), strides=(1, 1)).view(">u8")[:,0]
+    byte_idx = (offsets // 8).astype(np.int64)
+    shift    = (offsets % 8).astype(np.uint64)
+    high     = words[byte_idx].astype(np.uint64)
+    low      = padded[byte_idx + 8].astype(np.uint64) >> (np.uint64(8) - shift)
+    high     = np.where(shift > 0, (high << shift) | low, high)
+    return high >> (np.uint64(64) - lengths.astype(np.uint64))
+
+def handle_gorilla(data, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    dtype = np.dtype("="+data_type)
+    n, n_windows, n_bits = np.frombuffer(data, dtype=np.uint64, count=3)
+    offset  = 24
+    codes   = np.unpackbits(np.frombuffer(data, dtype=np.uint8, count=(2*int(n) + 7)//8, offset=offset))
+    codes   = (2*codes[0:2*int(n):2] + codes[1:2*int(n):2]).astype(np.int64)
+    offset += (2*int(n) + 7)//8
+    windows = np.frombuffer(data, dtype=np.uint8, count=2*int(n_windows), offset=offset).reshape(-1,2).astype(np.uint64)
+    offset += 2*int(n_windows)
+    stream  = np.frombuffer(data, dtype=np.uint8, offset=offset)
+
+    if dtype.kind == 'f':
+        window_idx = np.cumsum(codes == 2) - 1
+        nonzero    = codes > 0
+        lz         = windows[window_idx[nonzero], 0]
+        lengths    = windows[window_idx[nonzero], 1]
+        offsets    = np.cumsum(lengths) - lengths
+        deltas     = np.zeros(int(n), dtype=np.uint64)
+        deltas[nonzero] = extract_bits(stream, offsets, lengths) << (np.uint64(64) - lz - lengths)
+        words = np.bitwise_xor.accumulate(deltas)
+        word_t = np.uint32 if dtype.itemsize == 4 else np.uint64
+        values = words.astype(word_t).view(dtype)
+    else:
+        nonzero = codes > 0
+        lengths = GORILLA_DOD_BITS[codes[nonzero]]
+        offsets = np.cumsum(lengths) - lengths
+        zigzag  = np.zeros(int(n), dtype=np.uint64)
+        zigzag[nonzero] = extract_bits(stream, offsets, lengths)
+        dod     = (zigzag >> np.uint64(1)).astype(np.int64) ^ -(zigzag & np.uint64(1)).astype(np.int64)
+        ticks   = np.cumsum(np.cumsum(dod))
+        values  = ticks.view(dtype) if dtype.kind in "Mm" else ticks.astype(dtype)
+    return values.reshape(data_shape)
+
+# last full frame of every tile encoded image stream, patched in place with the changed tiles
+image_streams = {}
+
+def handle_tiles(data, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    dtype      = np.dtype("="+data_type)
+    tile_shape = (int(enc_args[0]), int(enc_args[1]))
+    image_name = enc_args[2] if len(enc_args) > 2 else ""
+    keyframe, n_changed = np.frombuffer(data, dtype=np.uint32, count=2)
+    frame = image_streams.get(data_sym)
+
+    if keyframe:
+        frame = np.frombuffer(data, dtype=dtype, count=data_len, offset=8).reshape(data_shape).copy()
+        image_streams[data_sym] = frame
+    elif (frame is None) or (frame.shape != data_shape) or (frame.dtype != dtype):
+        # missed the keyframe, show an empty frame until the next one arrives
+        frame = np.zeros(data_shape, dtype=dtype)
+        image_streams[data_sym] = frame
+    else:
+        tiles_per_row = -(-data_shape[1] // tile_shape[1])
+        tile_idx      = np.frombuffer(data, dtype=np.uint32, count=n_changed, offset=8)
+        offset        = 8 + 4*int(n_changed)
+        for idx in tile_idx:
+            row  = (int(idx) // tiles_per_row)*tile_shape[0]
+            col  = (int(idx) %  tiles_per_row)*tile_shape[1]
+            tile = frame[row:row+tile_shape[0], col:col+tile_shape[1]]
+            tile[...] = np.frombuffer(data, dtype=dtype, count=tile.size, offset=offset).reshape(tile.shape)
+            offset   += tile.nbytes
+
+    # read only view, the plot script must not modify the frame later deltas are applied to
+    view = frame.view()
+    view.flags.writeable = False
+    if image_name and (image_name in aeval.symtable):
+        aeval.symtable[image_name].set_data(view)
+    return view
+
+class Waterfall:
+    """
+    Rolling spectrogram image (frequency x time) fed by Cppyplot::spectrogram, holds the last 'history' columns.
+    show() draws it with imshow, columns received later update the image and its time extent in place,
+    columns lost in between (dropped messages) are left empty.
+    """
+    def __init__(self, fft_size, hop, history, sample_rate, scale):
+        self.params      = (fft_size, hop, history, sample_rate, scale)
+        self.fft_size    = fft_size
+        self.hop         = hop
+        self.history     = history
+        self.sample_rate = sample_rate
+        self.scale       = scale
+        self.freqs       = np.arange(fft_size//2 + 1)*sample_rate/fft_size
+        self.data        = np.full((len(self.freqs), history), np.nan, dtype=np.float32)
+        self.n_columns   = 0
+        self.image       = None
+        self.autoscale   = True
+
+    def times(self):
+        # center time of every image column, same convention as plt.specgram
+        columns = np.arange(self.n_columns - self.history, self.n_columns)
+        return (columns*self.hop + self.fft_size/2)/self.sample_rate
+
+    def extent(self):
+        times = self.times()
+        dt, df = self.hop/self.sample_rate, self.sample_rate/self.fft_size
+        return (times[0] - dt/2, times[-1] + dt/2, -df/2, self.freqs[-1] + df/2)
+
+    def append(self, first_column, columns):
+        n_new = len(columns)
+        shift = min(first_column + n_new - self.n_columns, self.history)
+        if (shift > 0):
+            self.data[:, :self.history - shift] = self.data[:, shift:]
+            self.data[:, self.history - shift:] = np.nan
+            n_keep = min(n_new, self.history)
+            self.data[:, self.history - n_keep:] = columns[n_new - n_keep:].T
+            self.n_columns = first_column + n_new
+
+        if (self.image is not None):
+            self.image.set_data(self.data)
+            self.image.set_extent(self.extent())
+            if self.autoscale and np.isfinite(self.data).any():
+                self.image.autoscale()
+
+    def show(self, ax=None, **kwargs):
+        ax = plt.gca() if ax is None else ax
+        self.autoscale = not any(key in kwargs for key in ("vmin", "vmax", "norm", "clim"))
+        kwargs = {"origin": "lower", "aspect": "auto", "interpolation": "nearest", **kwargs}
+        self.image = ax.imshow(self.data, extent=self.extent(), **kwargs)
+        return self.image
+
+waterfalls = {}
+
+def handle_stft(data, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    fft_size, hop, history, scale = int(enc_args[0]), int(enc_args[1]), int(enc_args[2]), enc_args[3]
+    first_column, n_columns = (int(value) for value in np.frombuffer(data, dtype=np.uint64, count=2))
+    sample_rate = float(np.frombuffer(data, dtype=np.float64, count=1, offset=16)[0])
+    columns     = np.frombuffer(data, dtype=np.float32, count=n_columns*data_len, offset=24).reshape(n_columns, data_len)
+
+    # new stream on first use, on parameter change and when the C++ side was reset
+    waterfall = waterfalls.get(data_sym)
+    if (waterfall is None) or (waterfall.params != (fft_size, hop, history, sample_rate, scale)) or (first_column < waterfall.n_columns):
+        waterfall = Waterfall(fft_size, hop, history, sample_rate, scale)
+        waterfalls[data_sym] = waterfall
+    waterfall.append(first_column, columns)
+    return waterfall
+
+def handle_downscale(data, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    # imshow extent of the original container, so that axes stay in original pixel coordinates
+    rows, cols = int(enc_args[0]), int(enc_args[1])
+    plot_data[data_sym + "_extent"] = (-0.5, cols - 0.5, rows - 0.5, -0.5)
+    return handle_payload(data, data_type, data_len, data_shape)
+
+def handle_hist(data, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    # same tuple as np.histogram: (counts, edges)
+    bins   = int(enc_args[0])
+    edges  = np.frombuffer(data, dtype=np.float64, count=bins+1)
+    counts = np.frombuffer(data, dtype=np.int64, count=bins, offset=edges.nbytes)
+    return (counts, edges)
+
+def handle_hist2d(data, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    # same tuple as np.histogram2d: (counts, x_edges, y_edges), counts has shape (x_bins, y_bins)
+    x_bins, y_bins = int(enc_args[0]), int(enc_args[1])
+    x_edges = np.frombuffer(data, dtype=np.float64, count=x_bins+1)
+    y_edges = np.frombuffer(data, dtype=np.float64, count=y_bins+1, offset=x_edges.nbytes)
+    counts  = np.frombuffer(data, dtype=np.int64, count=x_bins*y_bins, offset=x_edges.nbytes+y_edges.nbytes)
+    return (counts.reshape(x_bins, y_bins), x_edges, y_edges)
+
+def handle_hexbin(data, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    # center and count of every hexagon, plt.hexbin(*x, **x_hexbin) re-bins every center into its own hexagon 
+    # and sums the counts, empty hexagons get exactly one center (count 0) and are drawn like plt.hexbin without C does
+    nx, ny = int(enc_args[0]), int(enc_args[1])
+    extent = np.frombuffer(data, dtype=np.float64, count=4)
+    counts = np.frombuffer(data, dtype=np.int64, count=data_len, offset=extent.nbytes)
+    xmin, xmax, ymin, ymax = (float(v) for v in extent)
+
+    # lattice of Axes.hexbin
+    padding = 1.e-9 * (xmax - xmin)
+    sx = ((xmax + padding) - (xmin - padding)) / nx
+    sy = (ymax - ymin) / ny
+    x1, y1 = np.meshgrid(np.arange(nx+1), np.arange(ny+1), indexing="ij")
+    x2, y2 = np.meshgrid(np.arange(nx) + 0.5, np.arange(ny) + 0.5, indexing="ij")
+    centers_x = np.concatenate([x1.ravel(), x2.ravel()])*sx + (xmin - padding)
+    centers_y = np.concatenate([y1.ravel(), y2.ravel()])*sy + ymin
+
+    plot_data[data_sym + "_hexbin"] = {"gridsize": (nx, ny), "extent": (xmin, xmax, ymin, ymax), 
+                                       "reduce_C_function": np.sum}
+    return (centers_x, centers_y, counts)
+
+def handle_kde(data, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    # (grid, density)
+    size = int(enc_args[0])
+    grid = np.frombuffer(data, dtype=np.float64, count=size)
+    return (grid, np.frombuffer(data, dtype=np.float64, count=size, offset=grid.nbytes))
+
+def handle_kde2d(data, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    # (x_grid, y_grid, density), density has shape (y, x) like contour expects
+    size    = int(enc_args[0])
+    grids   = np.frombuffer(data, dtype=np.float64, count=2*size)
+    density = np.frombuffer(data, dtype=np.float64, count=size*size, offset=grids.nbytes)
+    return (grids[:size], grids[size:], density.reshape(size, size))
+
+class Distribution:
+    """
+    Distribution sent by Cppyplot::hdr_histogram (bucket ranges and counts) or Cppyplot::tdigest (centroids),
+    quantiles are read from the cumulative counts, buckets report their highest value like HdrHistogram does
+    and centroids are interpolated like t-digest does.
+    """
+    def __init__(self, values, counts, count, min_value, max_value, interpolate):
+        self.values      = values
+        self.counts      = counts
+        self.count       = count
+        self.min         = min_value
+        self.max         = max_value
+        self.interpolate = interpolate
+        self.cumulative  = np.cumsum(counts)
+
+    def mean(self):
+        return float(np.sum(self.values*self.counts)/max(self.count, 1))
+
+    def quantile(self, q):
+        q = np.clip(np.asarray(q, dtype=np.float64), 0.0, 1.0)
+        if (len(self.values) == 0):
+            return np.full(q.shape, np.nan)
+        if (self.interpolate):
+            centers = self.cumulative - self.counts/2.0
+            return np.interp(q*self.count, np.concatenate([[0.0], centers, [self.count]]), 
+                             np.concatenate([[self.min], self.values, [self.max]]))
+        rank = np.maximum(np.ceil(q*self.cumulative[-1]), 1)
+        idx  = np.minimum(np.searchsorted(self.cumulative, rank), len(self.values) - 1)
+        return np.minimum(self.values[idx], self.max)
+
+    def cdf(self):
+        return (self.values, self.cumulative/self.cumulative[-1]) if len(self.values) else (self.values, self.values)
+
+    def plot_cdf(self, ax=None, **kwargs):
+        ax = plt.gca() if ax is None else ax
+        values, fraction = self.cdf()
+        return ax.step(values, fraction, where="post", **kwargs)
+
+    def plot_percentiles(self, ax=None, max_percentile=99.999, **kwargs):
+        # classic latency percentile plot, x axis is 1/(1 - q) on a log scale labelled by percentile
+        ax = plt.gca() if ax is None else ax
+        tail  = 1.0 - max_percentile/100.0
+        q     = 1.0 - np.logspace(0.0, np.log10(tail), 512)
+        lines = ax.plot(1.0/(1.0 - q), self.quantile(q), **kwargs)
+        ax.set_xscale("log")
+        n_nines = int(np.ceil(-np.log10(tail)))
+        ticks   = [2.0] + [10.0**i for i in range(1, n_nines + 1)]
+        labels  = ["50%"] + [("%.*f" % (max(i - 2, 0), 100.0 - 10.0**(2 - i))) + "%" for i in range(1, n_nines + 1)]
+        ax.set_xticks(ticks)
+        ax.set_xticklabels(labels)
+        ax.set_xticks([], minor=True)
+        ax.set_xlabel("percentile")
+        return lines
+
+def handle_hdr(data, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    total, min_value, max_value, n_buckets = np.frombuffer(data, dtype=np.uint64, count=4)
+    buckets = np.frombuffer(data, dtype=np.uint64, count=3*int(n_buckets), offset=32).reshape(-1, 3)
+    return Distribution(buckets[:,1].astype(np.float64), buckets[:,2].astype(np.float64), float(total), 
+                        float(min_value), float(max_value), interpolate=False)
+
+def handle_tdigest(data, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    count, min_value, max_value = np.frombuffer(data, dtype=np.float64, count=3)
+    centroids = np.frombuffer(data, dtype=np.float64, offset=24).reshape(-1, 2)
+    return Distribution(centroids[:,0], centroids[:,1], float(count), float(min_value), float(max_value), interpolate=True)
+
+def handle_sparse(frames, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    # frames: outer index, inner index, values of a compressed sparse matrix, used without copying
+    import scipy.sparse
+    layout, index_type = enc_args[0], "=" + enc_args[1]
+    indptr  = np.frombuffer(frames[0], dtype=index_type)
+    indices = np.frombuffer(frames[1], dtype=index_type)
+    values  = np.frombuffer(frames[2], dtype="="+data_type)
+    matrix_t = scipy.sparse.csr_matrix if (layout == "csr") else scipy.sparse.csc_matrix
+    return matrix_t((values, indices, indptr), shape=data_shape, copy=False)
+
+class TriangleMesh:
+    """
+    Mesh sent by Cppyplot::_mesh, vertices (N x 3) and faces (F x 3 vertex indices, polygons if wider),
+    the matplotlib collection, triangulation or VTK cell array is built from it in a single call.
+    """
+    def __init__(self, vertices, faces):
+        self.vertices = vertices
+        self.faces    = faces
+
+    @staticmethod
+    def axes3d(ax):
+        ax = plt.gca() if ax is None else ax
+        return ax if (ax.name == "3d") else plt.gcf().add_subplot(projection="3d")
+
+    def plot_trisurf(self, ax=None, **kwargs):
+        ax = TriangleMesh.axes3d(ax)
+        return ax.plot_trisurf(self.vertices[:,0], self.vertices[:,1], self.vertices[:,2], triangles=self.faces, **kwargs)
+
+    def poly3d(self, ax=None, **kwargs):
+        from mpl_toolkits.mplot3d.art3d import Poly3DCollection
+        ax = TriangleMesh.axes3d(ax)
+        collection = Poly3DCollection(self.vertices[self.faces], **kwargs)
+        ax.add_collection3d(collection)
+        if (len(self.vertices) > 0):
+            low, high = self.vertices.min(axis=0), self.vertices.max(axis=0)
+            ax.set_xlim(low[0], high[0])
+            ax.set_ylim(low[1], high[1])
+            ax.set_zlim(low[2], high[2])
+        return collection
+
+    def triangulation(self):
+        import matplotlib.tri as mtri
+        return mtri.Triangulation(self.vertices[:,0], self.vertices[:,1], self.faces)
+
+    def vtk_faces(self):
+        # VTK/pyvista cell array, every face is prefixed with its vertex count
+        sizes = np.full((len(self.faces), 1), self.faces.shape[1], dtype=self.faces.dtype)
+        return np.hstack([sizes, self.faces]).ravel()
+
+def handle_mesh(frames, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    # frames: vertices, faces, both used without copying
+    index_type, n_faces, face_size = "=" + enc_args[0], int(enc_args[1]), int(enc_args[2])
+    vertices = np.frombuffer(frames[0], dtype="="+data_type).reshape(data_shape)
+    faces    = np.frombuffer(frames[1], dtype=index_type).reshape(n_faces, face_size)
+    return TriangleMesh(vertices, faces)
+
+class IsoLines:
+    """
+    Iso-lines extracted by Cppyplot::_contour, lines[i] holds the polylines (n x 2, x y) of levels[i].
+    plot() draws one LineCollection per level, coloured from a colormap over the levels like plt.contour.
+    """
+    def __init__(self, levels, lines):
+        self.levels = levels
+        self.lines  = lines
+
+    def plot(self, ax=None, cmap=None, colors=None, **kwargs):
+        from matplotlib.collections import LineCollection
+        ax = plt.gca() if ax is None else ax
+        if colors is None:
+            norm   = plt.Normalize(self.levels.min(), self.levels.max()) if len(self.levels) > 1 else (lambda level: 0.5)
+            colors = [plt.get_cmap(cmap)(norm(level)) for level in self.levels]
+        elif isinstance(colors, str):
+            colors = [colors]*len(self.levels)
+        collections = []
+        for level_lines, color in zip(self.lines, colors):
+            collection = LineCollection(level_lines, colors=[color], **kwargs)
+            ax.add_collection(collection)
+            collections.append(collection)
+        ax.autoscale_view()
+        return collections
+
+def handle_contour(frames, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    # frames: levels, first line of every level, first point of every line, points; lines are views into the points
+    levels        = np.frombuffer(frames[0], dtype=np.float64)
+    level_offsets = np.frombuffer(frames[1], dtype=np.uint64).astype(np.int64)
+    line_offsets  = np.frombuffer(frames[2], dtype=np.uint64).astype(np.int64)
+    points        = np.frombuffer(frames[3], dtype=np.float64).reshape(-1, 2)
+    lines         = [points[line_offsets[i]:line_offsets[i + 1]] for i in range(len(line_offsets) - 1)]
+    return IsoLines(levels, [lines[level_offsets[l]:level_offsets[l + 1]] for l in range(len(levels))])
+
+class Scope:
+    """
+    Samples of a variable watched with pyp.watch, streamed in batches by the C++ sampler thread.
+    Keeps the last 'history' samples, t (seconds since the sampler started) and values (n x width).
+    show() draws one line per value column, later batches update the lines and rescale the axes.
+    """
+    def __init__(self, watch_id, dtype, width, history):
+        self.watch_id = watch_id
+        self.history  = history
+        self.t_buffer = np.zeros(history, dtype=np.float64)
+        self.v_buffer = np.zeros((history, width), dtype=dtype)
+        self.count    = 0
+        self.lines    = None
+
+    @property
+    def t(self):
+        return self.t_buffer[self.history - self.count:]
+
+    @property
+    def values(self):
+        return self.v_buffer[self.history - self.count:]
+
+    def append(self, times, values):
+        n_new = min(len(times), self.history)
+        if (n_new == 0):
+            return
+        self.t_buffer[:self.history - n_new] = self.t_buffer[n_new:]
+        self.v_buffer[:self.history - n_new] = self.v_buffer[n_new:]
+        self.t_buffer[self.history - n_new:] = times[len(times) - n_new:]*1e-9
+        self.v_buffer[self.history - n_new:] = values[len(values) - n_new:]
+        self.count = min(self.count + n_new, self.history)
+
+        if (self.lines is not None):
+            for column, line in enumerate(self.lines):
+                line.set_data(self.t, self.values[:, column])
+            ax = self.lines[0].axes
+            ax.relim()
+            ax.autoscale_view()
+            ax.figure.canvas.draw_idle()
+            ax.figure.canvas.flush_events()
+
+    def show(self, ax=None, **kwargs):
+        ax = plt.gca() if ax is None else ax
+        self.lines = ax.plot(self.t, self.values, **kwargs)
+        return self.lines
+
+scopes = {}
+
+def handle_watch(data, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    watch_id, history = int(enc_args[0]), int(enc_args[1])
+    n_samples, width  = data_shape
+    times  = np.frombuffer(data, dtype=np.int64, count=n_samples)
+    values = np.frombuffer(data, dtype="="+data_type, count=n_samples*width, offset=times.nbytes).reshape(n_samples, width)
+
+    # a new watch of the same name starts a new scope
+    scope = scopes.get(data_sym)
+    if (scope is None) or (scope.watch_id != watch_id):
+        scope = Scope(watch_id, values.dtype, width, history)
+        scopes[data_sym] = scope
+    scope.append(times, values)
+    return scope
+
+class Capture:
+    """
+    Pre/post trigger windows of a Cppyplot::triggered_capture, the last 'history' windows are kept.
+    t is the time of every window sample relative to its trigger (in samples when sample_rate is 1),
+    windows[i] (window x width) was triggered at sample index triggers[i], missed counts triggers dropped on C++ side.
+    show() draws the latest window and follows new captures, overlay=True keeps the previous windows faded.
+    """
+    def __init__(self, capture_id, pre, post, history=32):
+        self.capture_id  = capture_id
+        self.pre         = pre
+        self.post        = post
+        self.history     = history
+        self.sample_rate = 1.0
+        self.missed      = 0
+        self.triggers    = []
+        self.windows     = []
+        self.ax          = None
+        self.overlay     = False
+        self.kwargs      = {}
+
+    @property
+    def t(self):
+        return np.arange(-self.pre, self.post)/self.sample_rate
+
+    @property
+    def latest(self):
+        return self.windows[-1] if self.windows else None
+
+    def append(self, sample_rate, triggers, windows, missed):
+        self.sample_rate = sample_rate
+        self.missed      = missed
+        self.triggers    = (self.triggers + list(triggers))[-self.history:]
+        self.windows     = (self.windows + list(windows))[-self.history:]
+        if (self.ax is not None) and (len(windows) > 0):
+            self.draw()
+
+    def draw(self):
+        ax = self.ax
+        for line in self.lines:
+            line.remove()
+        self.lines = []
+        if self.overlay:
+            for window in self.windows[:-1]:
+                self.lines += ax.plot(self.t, window, color="0.7", linewidth=0.5)
+        if self.windows:
+            self.lines += ax.plot(self.t, self.windows[-1], **self.kwargs)
+            ax.set_title(f"trigger at sample {self.triggers[-1]}, {len(self.windows)} captures, {self.missed} missed")
+        ax.relim()
+        ax.autoscale_view()
+        ax.figure.canvas.draw_idle()
+        ax.figure.canvas.flush_events()
+
+    def show(self, ax=None, overlay=False, **kwargs):
+        self.ax      = plt.gca() if ax is None else ax
+        self.overlay = overlay
+        self.kwargs  = kwargs
+        self.lines   = []
+        self.ax.axvline(0.0, color="k", linestyle="--", linewidth=0.8)
+        self.draw()
+        return self.lines
+
+captures = {}
+
+def handle_capture(data, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    capture_id, pre, post, missed = (int(arg) for arg in enc_args)
+    n_windows, window, width = data_shape
+    sample_rate = np.frombuffer(data, dtype=np.float64, count=1)[0]
+    triggers    = np.frombuffer(data, dtype=np.uint64, count=n_windows, offset=8)
+    windows     = np.frombuffer(data, dtype="="+data_type, count=n_windows*window*width,
+                                offset=8 + triggers.nbytes).reshape(n_windows, window, width)
+
+    # a new capture object of the same name starts over
+    capture = captures.get(data_sym)
+    if (capture is None) or (capture.capture_id != capture_id):
+        capture = Capture(capture_id, pre, post)
+        captures[data_sym] = capture
+    capture.append(float(sample_rate), triggers.tolist(), windows.copy(), missed)
+    return capture
+
+profile_dtype = np.dtype([("begin", "=i8"), ("end", "=i8"), ("name", "=u4"), ("thread", "=u2"), ("depth", "=u2")])
+# scope name ids are shared by every profile of the C++ process
+profile_names = []
+
+class Profile:
+    """
+    Scopes recorded with CPPYPLOT_SCOPE, scopes of the last 'history' seconds are kept in events
+    (begin, end (ns since the C++ profiler started), name id, thread, depth), names maps ids to scope names.
+    timeline() draws one lane per thread and nesting depth, flame() the inclusive time of every call path,
+    summary() returns (count, total seconds, mean seconds) per name.
+    Drawn plots follow new batches, redrawn at most every 'redraw_interval' seconds.
+    """
+    def __init__(self, history=10.0):
+        self.history         = history
+        self.redraw_interval = 0.5
+        self.names           = profile_names
+        self.events          = np.zeros(0, dtype=profile_dtype)
+        self.dropped         = 0
+        self.views           = []
+        self.last_redraw     = 0.0
+
+    def append(self, events, dropped):
+        self.dropped = dropped
+        if (len(events) == 0):
+            return
+        self.events = np.concatenate((self.events, events))
+        self.events = self.events[self.events["end"] >= self.events["end"].max() - int(self.history*1e9)]
+        if (time.monotonic() - self.last_redraw) < self.redraw_interval:
+            return
+        self.last_redraw = time.monotonic()
+        for draw, ax in self.views:
+            ax.clear()
+            draw(ax)
+            ax.figure.canvas.draw_idle()
+        if self.views:
+            self.views[0][1].figure.canvas.flush_events()
+
+    def summary(self):
+        durations = (self.events["end"] - self.events["begin"])*1e-9
+        counts    = np.bincount(self.events["name"], minlength=len(self.names))
+        totals    = np.bincount(self.events["name"], weights=durations, minlength=len(self.names))
+        return {self.names[i]: (int(counts[i]), totals[i], totals[i]/counts[i]) for i in np.flatnonzero(counts)}
+
+    def color(self, name_ids):
+        return plt.get_cmap("tab20")(np.asarray(name_ids) % 20)
+
+    def draw_timeline(self, ax):
+        events, lane = self.events, 0
+        ticks, labels = [], []
+        for thread in np.unique(events["thread"]):
+            thread_events = events[events["thread"] == thread]
+            for depth in range(int(thread_events["depth"].max()) + 1):
+                lane_events = thread_events[thread_events["depth"] == depth]
+                ax.broken_barh(np.column_stack((lane_events["begin"]*1e-9, (lane_events["end"] - lane_events["begin"])*1e-9)),
+                               (lane - 0.45, 0.9), facecolors=self.color(lane_events["name"]))
+                lane += 1
+            ticks.append(lane - 1 - thread_events["depth"].max()/2)
+            labels.append(f"thread {thread}")
+        ax.set_yticks(ticks)
+        ax.set_yticklabels(labels)
+        ax.invert_yaxis()
+        ax.set_xlabel("time [s]")
+        handles = [plt.Rectangle((0, 0), 1, 1, color=self.color(n)) for n in np.unique(events["name"])]
+        ax.legend(handles, [self.names[n] for n in np.unique(events["name"])], loc="upper left", fontsize="small")
+        ax.set_title(f"{len(events)} scopes, {self.dropped} dropped")
+
+    def call_paths(self):
+        # inclusive time of every call path, parents begin before (or with) their children
+        totals = {}
+        for thread in np.unique(self.events["thread"]):
+            thread_events = np.sort(self.events[self.events["thread"] == thread], order=["begin", "depth"])
+            stack = []
+            for begin, end, name, _, depth in thread_events.tolist():
+                del stack[depth:]
+                if (len(stack) != depth):
+                    continue   # parent is outside the kept history
+                stack.append(self.names[name])
+                path = tuple(stack)
+                totals[path] = totals.get(path, 0) + (end - begin)
+        return totals
+
+    def draw_flame(self, ax):
+        totals = self.call_paths()
+        children = {}
+        for path in totals:
+            children.setdefault(path[:-1], []).append(path)
+        def layout(parent, left):
+            for path in sorted(children.get(parent, [])):
+                width = totals[path]*1e-9
+                ax.barh(len(path) - 1, width, left=left, height=0.95, color=self.color(self.names.index(path[-1])), edgecolor="white")
+                ax.text(left + width/2, len(path) - 1, path[-1], ha="center", va="center", fontsize="small", clip_on=True)
+                layout(path, left)
+                left += width
+        layout((), 0.0)
+        ax.set_xlabel("inclusive time [s]")
+        ax.set_ylabel("depth")
+        ax.set_title("flame graph")
+
+    def timeline(self, ax=None):
+        ax = plt.gca() if ax is None else ax
+        self.views.append((self.draw_timeline, ax))
+        self.draw_timeline(ax)
+        return ax
+
+    def flame(self, ax=None):
+        ax = plt.gca() if ax is None else ax
+        self.views.append((self.draw_flame, ax))
+        self.draw_flame(ax)
+        return ax
+
+profiles = {}
+
+def handle_profile(frames, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    first_name, dropped = int(enc_args[0]), int(enc_args[1])
+    names = frames[0].decode("utf-8").split("\n")[:-1]
+    del profile_names[first_name:]
+    profile_names.extend(names)
+    events = np.frombuffer(frames[1], dtype=profile_dtype)
+
+    profile = profiles.get(data_sym)
+    if (profile is None):
+        profile = Profile()
+        profiles[data_sym] = profile
+    profile.append(events, dropped)
+    return profile
+
+class TiledImage:
+    """
+    Image pyramid served by Cppyplot::image_pyramid, tiles intersecting the current view are requested
+    at the level matching the screen resolution and cached, show() draws it and follows zoom/pan.
+    A request that is not answered within TIMEOUT_MS (pyramid destroyed, reply lost) is dropped, the REQ socket
+    is recreated and the tiles are requested again on the next zoom/pan.
+    """
+    TIMEOUT_MS = 2000
+
+    def __init__(self, pyramid_id, address, dtype, tile_size, level_shapes):
+        self.pyramid_id   = pyramid_id
+        self.address      = address
+        self.dtype        = dtype
+        self.tile_size    = tile_size
+        self.level_shapes = level_shapes
+        self.cache        = {}
+        self.image        = None
+        self.view_lim     = None
+        self.socket       = None
+        self.connect()
+
+    def connect(self):
+        # a REQ socket that missed its reply cannot send again, it is replaced
+        if self.socket is not None:
+            self.socket.close()
+        self.socket = context.socket(zmq.REQ)
+        self.socket.setsockopt(zmq.LINGER, 0)
+        self.socket.connect(self.address)
+
+    def tile_shape(self, level, tile_row, tile_col):
+        rows, cols = self.level_shapes[level]
+        return (min(self.tile_size, rows - tile_row*self.tile_size), min(self.tile_size, cols - tile_col*self.tile_size))
+
+    def fetch(self, level, tile_rows, tile_cols):
+        keys    = [(level, r, c) for r in tile_rows for c in tile_cols]
+        missing = [key for key in keys if key not in self.cache]
+        if missing:
+            self.socket.send(np.array(missing, dtype=np.uint32).tobytes())
+            if not self.socket.poll(self.TIMEOUT_MS, zmq.POLLIN):
+                print("[Error] No tiles from image pyramid at %s" % self.address)
+                self.connect()
+                return False
+            reply  = self.socket.recv()
+            offset = 0
+            for key in missing:
+                shape = self.tile_shape(*key)
+                tile  = np.frombuffer(reply, dtype=self.dtype, count=shape[0]*shape[1], offset=offset)
+                self.cache[key] = tile.reshape(shape)
+                offset += tile.nbytes
+        return True
+
+    def view(self, ax):
+        rows, cols = self.level_shapes[0]
+        x0, x1 = sorted(ax.get_xlim())
+        y0, y1 = sorted(ax.get_ylim())
+        x0, x1 = max(x0 + 0.5, 0), min(x1 + 0.5, cols)
+        y0, y1 = max(y0 + 0.5, 0), min(y1 + 0.5, rows)
+        if (x1 <= x0) or (y1 <= y0):
+            return None, None
+
+        # coarsest level that still has one raster pixel per screen pixel
+        screen_width = max(ax.get_window_extent().width, 1.0)
+        level = int(np.clip(np.floor(np.log2(max((x1 - x0)/screen_width, 1.0))), 0, len(self.level_shapes) - 1))
+        scale = 2**level
+        lrows, lcols = self.level_shapes[level]
+        r0, r1 = int(y0 // scale), min(int(np.ceil(y1/scale)), lrows)
+        c0, c1 = int(x0 // scale), min(int(np.ceil(x1/scale)), lcols)
+        tile_rows = range(r0 // self.tile_size, (r1 - 1)//self.tile_size + 1)
+        tile_cols = range(c0 // self.tile_size, (c1 - 1)//self.tile_size + 1)
+        if not self.fetch(level, tile_rows, tile_cols):
+            return None, None
+
+        region = np.block([[self.cache[(level, r, c)] for c in tile_cols] for r in tile_rows])
+        row0, col0 = tile_rows[0]*self.tile_size, tile_cols[0]*self.tile_size
+        extent = (col0*scale - 0.5, min((col0 + region.shape[1])*scale, cols) - 0.5,
+                  min((row0 + region.shape[0])*scale, rows) - 0.5, row0*scale - 0.5)
+        return region, extent
+
+    def draw(self, renderer):
+        # tiles are fetched at draw time so that a zoom (xlim and ylim change) results in a single request
+        view_lim = (self.image.axes.get_xlim(), self.image.axes.get_ylim(), self.image.axes.get_window_extent().width)
+        if view_lim != self.view_lim:
+            self.view_lim  = view_lim
+            region, extent = self.view(self.image.axes)
+            if region is not None:
+                self.image.set_data(region)
+                self.image.set_extent(extent)
+        AxesImage.draw(self.image, renderer)
+
+    def show(self, ax=None, **imshow_kwargs):
+        ax = plt.gca() if ax is None else ax
+        rows, cols = self.level_shapes[0]
+        ax.set_xlim(-0.5, cols - 0.5)
+        ax.set_ylim(rows - 0.5, -0.5)
+        ax.set_autoscale_on(False)
+        region, extent = self.view(ax)
+        self.view_lim   = (ax.get_xlim(), ax.get_ylim(), ax.get_window_extent().width)
+        if region is None:
+            # no tiles yet, the first draw requests them again
+            region, extent = np.zeros((1, 1), dtype=self.dtype), (-0.5, cols - 0.5, rows - 0.5, -0.5)
+            self.view_lim  = None
+        self.image      = ax.imshow(region, extent=extent, **imshow_kwargs)
+        self.image.draw = self.draw
+        ax.set_autoscale_on(False)
+        return self.image
+
+# pyramids are kept alive across calls so tiles that were already transferred are not requested again
+image_pyramids = {}
+
+def handle_pyramid(data, data_type, data_len, data_shape, data_sym="", enc_args=()):
+    address    = enc_args[0]
+    descriptor = np.frombuffer(data, dtype=np.uint64)
+    pyramid_id, tile_size, n_levels = int(descriptor[0]), int(descriptor[1]), int(descriptor[2])
+    level_shapes = [tuple(int(v) for v in shape) for shape in descriptor[3:3 + 2*n_levels].reshape(-1, 2)]
+
+    pyramid = image_pyramids.get((data_sym, address))
+    if (pyramid is None) or (pyramid.pyramid_id != pyramid_id):
+        pyramid = TiledImage(pyramid_id, address, np.dtype("="+data_type), tile_size, level_shapes)
+        image_pyramids[(data_sym, address)] = pyramid
+    return pyramid
+
+# payload encoding (last header field) -> decoder
+payload_decoders = {
+    "raw"       : handle_payload,
+    "bits"      : handle_bits,
+    "arange"    : handle_arange,
+    "memmap"    : handle_memmap,
+    "fidelity"  : handle_fidelity,
+    "gorilla"   : handle_gorilla,
+    "tiles"     : handle_tiles,
+    "downscale" : handle_downscale,
+    "pyramid"   : handle_pyramid,
+    "hist"      : handle_hist,
+    "hist2d"    : handle_hist2d,
+    "hexbin"    : handle_hexbin,
+    "kde"       : handle_kde,
+    "kde2d"     : handle_kde2d,
+    "hdr"       : handle_hdr,
+    "tdigest"   : handle_tdigest,
+    "sparse"    : handle_sparse,
+    "mesh"      : handle_mesh,
+    "stft"      : handle_stft,
+    "contour"   : handle_contour,
+    "watch"     : handle_watch,
+    "capture"   : handle_capture,
+    "profile"   : handle_profile,
+}
 
 try:
     while(True):
@@ -107,20 +1269,37 @@ try:
             zmq_message = msg_queue.get()
             msg_queue.task_done()
         else:
+            now = time.monotonic()
+            publish_status(now)
+            events.pump(now)
+            render.update(now)
             continue
         
         if (zmq_message[0:4] == b"data"):
             data_info     = zmq_message.decode("utf-8").split('|')
-            # 0: data, 1: var_name, 2: var_type, 3: n_elems, 4: array_shape
+            # 0: data, 1: var_name, 2: var_type, 3: n_elems, 4: array_shape, 5: encoding, 6: n_frames
             data_type     = data_info[TYPE_IDX]
             data_len      = int(data_info[LEN_IDX])
             data_shape    = parse_shape(data_info[SHAPE_IDX])
-            data_payload  = msg_queue.get()
-            plot_data[data_info[SYM_IDX]] = handle_payload(data_payload, data_type, data_len, data_shape)
+            # encoding is either 'name' or 'name:arg0,arg1,...'
+            data_encoding = data_info[ENC_IDX] if len(data_info) > ENC_IDX else "raw"
+            data_encoding, _, enc_args = data_encoding.partition(':')
+            enc_args      = enc_args.split(',') if enc_args else []
+            data_sym      = data_info[SYM_IDX]
+            # multi frame payloads (sparse matrices, ...) are passed to the decoder as a list of frames
+            data_frames   = int(data_info[FRAMES_IDX]) if len(data_info) > FRAMES_IDX else 1
+            data_payload  = msg_queue.get() if (data_frames == 1) else [msg_queue.get() for _ in range(data_frames)]
+            plot_data[data_sym] = payload_decoders[data_encoding](data_payload, data_type, data_len, data_shape, data_sym, enc_args)
             msg_queue.task_done()
         elif(zmq_message[0:8] == b"finalize"):
             aeval.symtable = {**aeval.symtable, **plot_data}
+            eval_start = time.monotonic()
             aeval.eval(plot_cmd)
+            elapsed    = time.monotonic() - eval_start
+            eval_time  = elapsed if (calls_done == 0) else (0.8*eval_time + 0.2*elapsed)
+            calls_done += 1
+            publish_status(time.monotonic())
+            render.update(time.monotonic())
 
             # Some error happened pause execution by creating sample matplotlib windows
             if aeval.error_msg != None:
@@ -130,10 +1309,21 @@ try:
                 plt.show()
             plot_cmd  = None
             plot_data = {}
+        elif(zmq_message[0:11] == b"checkpoint|"):
+            try:
+                checkpoint(zmq_message[11:].decode("utf-8"))
+            except Exception as e:
+                print("[Error] Checkpoint failed: %s" % e)
+        elif(zmq_message[0:8] == b"restore|"):
+            try:
+                restore(zmq_message[8:].decode("utf-8"))
+            except Exception as e:
+                print("[Error] Restore failed: %s" % e)
         elif(zmq_message == b"exit"):
             print("[INFO] Received exit message, exiting")
             kill_thread = True
             subscriber_thread.join()
+            render.close()
             sys.exit(0)
         else:
             # print("[INFO] Executing ... \n")
@@ -143,4 +1333,5 @@ except KeyboardInterrupt as e:
     print("[Error] Received keyboardInterrupt, killing subscriber thread ")
     kill_thread = True
     subscriber_thread.join()
+    render.close()
     sys.exit(e)
@@ -0,0 +1,120 @@
+#ifndef _CPPYPLOT_SESSION_H_
+#define _CPPYPLOT_SESSION_H_
+
+/*
+  * Session recording: every frame sent to the server (headers, payloads, plot commands, finalize) is appended
+  * to a log file together with its send time, cppyplot_replay.py feeds the log to cppyplot_server.py again
+  * at any speed or from any time. Tile requests of image pyramids are answered live and are not recorded.
+  * log  : "CPPYREC\0" | version (uint32) | reserved (uint32) | start (int64 ns since unix epoch) | reserved (uint64)
+  *        frames: time (int64 ns since start) | flags (uint32) | reserved (uint32) | size (uint64) | bytes,
+  *        every frame padded to 8 bytes. flags: 1 payload frame, 2 first frame of a message (pyp.raw call, watch batch, ...),
+  *        a replay may start at any message.
+  * index: "CPPYIDX\0" | (time (int64), log offset (uint64)) of the first message every SESSION_INDEX_INTERVAL,
+  *        the replay seeks by bisecting it (log files stay memory mappable, the index is written next to the log as <path>.idx)
+  * Frames are written while sending (buffered), both files are flushed with every index entry.
+*/
+constexpr std::chrono::milliseconds SESSION_INDEX_INTERVAL{100};
+
+class session_recorder{
+  private:
+    std::FILE *   log_   = nullptr;
+    std::FILE *   index_ = nullptr;
+    std::uint64_t offset_ = 0u;
+    std::int64_t  start_  = 0;
+    std::int64_t  next_index_ = 0;
+    bool          message_start_ = true;
+
+    static std::int64_t now_ns() noexcept
+    { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+
+    template<typename T>
+    void put(std::FILE* file, const T& value) noexcept
+    { std::fwrite(&value, sizeof(T), 1u, file); }
+
+  public:
+    session_recorder() = default;
+    session_recorder(const session_recorder&) = delete;
+    session_recorder& operator=(const session_recorder&) = delete;
+    ~session_recorder()
+    { close(); }
+
+    // starts a new recording, an existing file of the same name is replaced
+    bool open(const std::string& path)
+    {
+      close();
+      log_   = std::fopen(path.c_str(), "wb");
+      index_ = std::fopen((path + ".idx").c_str(), "wb");
+      if ((log_ == nullptr) || (index_ == nullptr))
+      {
+        close();
+        return false;
+      }
+      std::setvbuf(log_, nullptr, _IOFBF, 1u << 20u);
+
+      const std::int64_t unix_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::system_clock::now().time_since_epoch()).count();
+      std::fwrite("CPPYREC", 8u, 1u, log_);
+      put(log_, std::uint32_t{1u});
+      put(log_, std::uint32_t{0u});
+      put(log_, unix_ns);
+      put(log_, std::uint64_t{0u});
+      std::fwrite("CPPYIDX", 8u, 1u, index_);
+
+      offset_     = 32u;
+      start_      = now_ns();
+      next_index_ = 0;
+      return true;
+    }
+
+    void close()
+    {
+      if (log_ != nullptr)
+      { std::fclose(log_); }
+      if (index_ != nullptr)
+      { std::fclose(index_); }
+      log_   = nullptr;
+      index_ = nullptr;
+    }
+
+    bool is_open() const noexcept
+    { return log_ != nullptr; }
+
+    // the next frame starts a message that does not depend on frames before it
+    void begin_message() noexcept
+    { message_start_ = true; }
+
+    void write(const zmq::message_t& frame, bool payload)
+    {
+      const std::int64_t time = now_ns() - start_;
+      if (message_start_ && (time >= next_index_))
+      {
+        put(index_, time);
+        put(index_, offset_);
+        std::fflush(log_);
+        std::fflush(index_);
+        next_index_ = time + std::chrono::duration_cast<std::chrono::nanoseconds>(SESSION_INDEX_INTERVAL).count();
+      }
+
+      const std::uint64_t size = frame.size();
+      put(log_, time);
+      put(log_, std::uint32_t{(payload ? 1u : 0u) | (message_start_ ? 2u : 0u)});
+      message_start_ = false;
+      put(log_, std::uint32_t{0u});
+      put(log_, size);
+      if (size > 0u)
+      { std::fwrite(frame.data(), 1u, size, log_); }
+
+      const std::uint64_t padding = (8u - (size % 8u)) % 8u;
+      const std::uint64_t zeros   = 0u;
+      std::fwrite(&zeros, 1u, padding, log_);
+      offset_ += 24u + size + padding;
+    }
+};
+
+inline session_recorder& recorder()
+{
+  static session_recorder session;
+  return session;
+}
+
+#endif
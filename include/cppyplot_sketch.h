@@ -0,0 +1,411 @@
+#ifndef _CPPYPLOT_SKETCH_H_
+#define _CPPYPLOT_SKETCH_H_
+
+/*
+  * Fixed memory distribution sketches for latency style data, both can be updated from many threads,
+  * merged with other sketches of the same type and sent with _p(sketch).
+  * Python side gets a Distribution object with quantile(q), plot_percentiles() and plot_cdf().
+*/
+
+/*
+  * HDR histogram of non negative integer values (e.g. nanoseconds)
+  * Log-linear buckets keep 'significant_digits' decimal digits of every value in [1, highest_trackable],
+  * larger values are recorded as highest_trackable (at most 2^62-1, like HdrHistogram's INT64_MAX/2).
+  * Counts are atomics, record() is lock free.
+  * payload: [total, min, max, n_buckets] (uint64) | (lowest, highest, count) (uint64) per non empty bucket
+*/
+class hdr_histogram{
+  public:
+    using value_type = std::uint64_t;
+
+  private:
+    std::uint64_t highest_trackable_;
+    unsigned int  significant_digits_;
+    unsigned int  sub_bucket_half_count_magnitude_;
+    std::uint64_t sub_bucket_half_count_;
+    std::uint64_t sub_bucket_mask_;
+    std::size_t   counts_len_;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> counts_;
+    std::atomic<std::uint64_t> min_;
+    std::atomic<std::uint64_t> max_;
+
+    std::size_t counts_index(std::uint64_t value) const noexcept
+    {
+      // bucket: power of two range holding the value, sub bucket: linear position inside it
+      const unsigned int pow2_ceiling = 64u - leading_zeros(value | sub_bucket_mask_);
+      const unsigned int bucket       = pow2_ceiling - (sub_bucket_half_count_magnitude_ + 1u);
+      const std::uint64_t sub_bucket  = value >> bucket;
+      return (static_cast<std::size_t>(bucket + 1u) << sub_bucket_half_count_magnitude_)
+             + static_cast<std::size_t>(sub_bucket - sub_bucket_half_count_);
+    }
+
+    std::uint64_t lowest_equivalent(std::size_t index) const noexcept
+    {
+      std::size_t   bucket     = index >> sub_bucket_half_count_magnitude_;
+      std::uint64_t sub_bucket = (index & (sub_bucket_half_count_ - 1u)) + sub_bucket_half_count_;
+      if (bucket == 0u)
+      { sub_bucket -= sub_bucket_half_count_; }
+      else
+      { bucket--; }
+      return sub_bucket << bucket;
+    }
+
+    std::uint64_t bucket_width(std::size_t index) const noexcept
+    {
+      const std::size_t bucket = index >> sub_bucket_half_count_magnitude_;
+      return std::uint64_t{1u} << ((bucket == 0u) ? 0u : bucket - 1u);
+    }
+
+  public:
+    explicit hdr_histogram(std::uint64_t highest_trackable = 3600000000000u, unsigned int significant_digits = 3u)
+      : highest_trackable_(std::clamp<std::uint64_t>(highest_trackable, 2u, (std::uint64_t{1u} << 62u) - 1u)),
+        significant_digits_(std::clamp(significant_digits, 1u, 5u)),
+        min_(std::numeric_limits<std::uint64_t>::max()), max_(0u)
+    {
+      std::uint64_t largest_single_unit = 2u;
+      for (unsigned int i = 0u; i < significant_digits_; i++)
+      { largest_single_unit *= 10u; }
+
+      unsigned int sub_bucket_count_magnitude = 0u;
+      while ((std::uint64_t{1u} << sub_bucket_count_magnitude) < largest_single_unit)
+      { sub_bucket_count_magnitude++; }
+      sub_bucket_half_count_magnitude_ = sub_bucket_count_magnitude - 1u;
+      sub_bucket_half_count_           = std::uint64_t{1u} << sub_bucket_half_count_magnitude_;
+      sub_bucket_mask_                 = (std::uint64_t{1u} << sub_bucket_count_magnitude) - 1u;
+
+      std::size_t   bucket_count = 1u;
+      std::uint64_t trackable    = std::uint64_t{1u} << sub_bucket_count_magnitude;
+      while ((trackable <= highest_trackable_) && (trackable < (std::uint64_t{1u} << 62u)))
+      {
+        trackable <<= 1u;
+        bucket_count++;
+      }
+      counts_len_ = (bucket_count + 1u)*static_cast<std::size_t>(sub_bucket_half_count_);
+      counts_     = std::make_unique<std::atomic<std::uint64_t>[]>(counts_len_);
+      reset();
+    }
+
+    hdr_histogram(const hdr_histogram& other) = delete;
+    hdr_histogram& operator=(const hdr_histogram& other) = delete;
+
+    void record(std::uint64_t value, std::uint64_t count = 1u) noexcept
+    {
+      value = std::min(value, highest_trackable_);
+      counts_[counts_index(value)].fetch_add(count, std::memory_order_relaxed);
+
+      std::uint64_t cur_min = min_.load(std::memory_order_relaxed);
+      while ((value < cur_min) && !min_.compare_exchange_weak(cur_min, value, std::memory_order_relaxed)) {}
+      std::uint64_t cur_max = max_.load(std::memory_order_relaxed);
+      while ((value > cur_max) && !max_.compare_exchange_weak(cur_max, value, std::memory_order_relaxed)) {}
+    }
+
+    template<typename Rep, typename Period>
+    void record(std::chrono::duration<Rep, Period> value, std::uint64_t count = 1u) noexcept
+    { record(static_cast<std::uint64_t>(std::max<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(value).count(), 0)), count); }
+
+    // adds the counts of 'other', histograms with a different layout are re-recorded bucket by bucket
+    void merge(const hdr_histogram& other) noexcept
+    {
+      for (std::size_t i = 0u; i < other.counts_len_; i++)
+      {
+        const std::uint64_t count = other.counts_[i].load(std::memory_order_relaxed);
+        if (count != 0u)
+        { record(other.lowest_equivalent(i), count); }
+      }
+      // lowest equivalent values are rounded down, keep the exact extremes
+      if (other.total_count() != 0u)
+      {
+        record(other.min(), 0u);
+        record(std::min(other.max(), highest_trackable_), 0u);
+      }
+    }
+
+    void reset() noexcept
+    {
+      for (std::size_t i = 0u; i < counts_len_; i++)
+      { counts_[i].store(0u, std::memory_order_relaxed); }
+      min_.store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed);
+      max_.store(0u, std::memory_order_relaxed);
+    }
+
+    std::uint64_t total_count() const noexcept
+    {
+      std::uint64_t total = 0u;
+      for (std::size_t i = 0u; i < counts_len_; i++)
+      { total += counts_[i].load(std::memory_order_relaxed); }
+      return total;
+    }
+
+    std::uint64_t min() const noexcept
+    { return (max_.load(std::memory_order_relaxed) == 0u) ? 0u : std::min(min_.load(std::memory_order_relaxed), max()); }
+
+    std::uint64_t max() const noexcept
+    { return max_.load(std::memory_order_relaxed); }
+
+    // highest value equivalent to the value at 'percentile' (0-100), same as HdrHistogram's getValueAtPercentile
+    std::uint64_t value_at_percentile(double percentile) const noexcept
+    {
+      const std::uint64_t total = total_count();
+      const double fraction     = std::clamp(percentile, 0.0, 100.0)/100.0;
+      const std::uint64_t rank  = std::max<std::uint64_t>(static_cast<std::uint64_t>(std::ceil(fraction*static_cast<double>(total))), 1u);
+      std::uint64_t running = 0u;
+      for (std::size_t i = 0u; i < counts_len_; i++)
+      {
+        running += counts_[i].load(std::memory_order_relaxed);
+        if (running >= rank)
+        { return std::min(lowest_equivalent(i) + bucket_width(i) - 1u, max()); }
+      }
+      return max();
+    }
+
+    std::size_t buckets() const noexcept
+    { return counts_len_; }
+
+    // (lowest, highest, count) of the non empty buckets, read bucket by bucket while other threads keep recording
+    std::vector<std::array<std::uint64_t, 3>> snapshot() const
+    {
+      std::vector<std::array<std::uint64_t, 3>> non_empty;
+      for (std::size_t i = 0u; i < counts_len_; i++)
+      {
+        const std::uint64_t count = counts_[i].load(std::memory_order_relaxed);
+        if (count != 0u)
+        { non_empty.push_back({lowest_equivalent(i), lowest_equivalent(i) + bucket_width(i) - 1u, count}); }
+      }
+      return non_empty;
+    }
+};
+
+inline std::size_t container_size(const hdr_histogram& data)
+{ return data.buckets(); }
+
+inline std::array<std::size_t, 1> container_shape(const hdr_histogram& data)
+{ return std::array<std::size_t, 1>{data.buckets()}; }
+
+inline std::string container_encoding(const hdr_histogram& data)
+{ (void)data; return "hdr"; }
+
+inline void fill_zmq_buffer(const hdr_histogram& data, zmq::message_t& buffer)
+{
+  const auto buckets  = data.snapshot();
+  std::uint64_t total = 0u;
+  for (const auto& bucket : buckets)
+  { total += bucket[2]; }
+
+  const std::array<std::uint64_t, 4> info{total, data.min(), data.max(), buckets.size()};
+  buffer.rebuild(sizeof(info) + buckets.size()*sizeof(buckets[0]));
+  char * ptr = static_cast<char*>(buffer.data());
+  std::memcpy(ptr, info.data(), sizeof(info));
+  if (!buckets.empty())
+  { std::memcpy(ptr + sizeof(info), buckets.data(), buckets.size()*sizeof(buckets[0])); }
+}
+
+/*
+  * t-digest (merging digest with the k2 scale function) of floating point values
+  * Keeps in the order of 'compression' centroids, accuracy is highest at the tails (p99, p99.9, ...).
+  * record() appends to one of TDIGEST_SHARDS buffers picked by thread id, each with its own lock,
+  * a full buffer is merged into the centroids of its shard. Shards are merged when the digest is read.
+  * payload: [count, min, max] (double) | (mean, weight) (double) per centroid, sorted by mean
+*/
+constexpr std::size_t TDIGEST_SHARDS = 8u;
+
+class tdigest{
+  public:
+    using value_type = double;
+
+    struct centroid{
+      double mean;
+      double weight;
+    };
+
+  private:
+    struct shard_t{
+      std::mutex            lock;
+      std::vector<double>   buffer;
+      std::vector<centroid> centroids;
+      double                count = 0.0;
+      double                min   = std::numeric_limits<double>::infinity();
+      double                max   = -std::numeric_limits<double>::infinity();
+    };
+
+    double compression_;
+    std::size_t buffer_size_;
+    mutable std::array<shard_t, TDIGEST_SHARDS> shards_;
+
+    // sorts and merges 'items' so that no centroid spans more than one unit of the k2 scale function
+    // k(q) = compression/Z(n)*log(q/(1 - q)), centroids get smaller towards both tails
+    static void compress(std::vector<centroid>& items, double compression)
+    {
+      if (items.size() < 2u)
+      { return; }
+      std::sort(items.begin(), items.end(), [](const centroid& a, const centroid& b){ return a.mean < b.mean; });
+
+      double total = 0.0;
+      for (const auto& item : items)
+      { total += item.weight; }
+
+      const double normalizer = compression/std::max(4.0*std::log(total/compression) + 24.0, 1.0);
+      auto weight_limit = [&](double weight_so_far)
+      {
+        const double q = weight_so_far/total;
+        const double k = normalizer*std::log(q/(1.0 - q)) + 1.0;
+        return total/(1.0 + std::exp(-k/normalizer));
+      };
+
+      std::size_t out = 0u;
+      double weight_so_far = 0.0;
+      double limit = weight_limit(0.0);
+      for (std::size_t i = 1u; i < items.size(); i++)
+      {
+        centroid& cur = items[out];
+        if (weight_so_far + cur.weight + items[i].weight <= limit)
+        {
+          cur.weight += items[i].weight;
+          cur.mean   += (items[i].mean - cur.mean)*items[i].weight/cur.weight;
+        }
+        else
+        {
+          weight_so_far += cur.weight;
+          limit = weight_limit(weight_so_far);
+          items[++out] = items[i];
+        }
+      }
+      items.resize(out + 1u);
+    }
+
+    void flush(shard_t& shard) const
+    {
+      for (const double value : shard.buffer)
+      { shard.centroids.push_back(centroid{value, 1.0}); }
+      shard.buffer.clear();
+      compress(shard.centroids, compression_);
+    }
+
+    shard_t& shard_of_thread()
+    { return shards_[std::hash<std::thread::id>{}(std::this_thread::get_id()) % TDIGEST_SHARDS]; }
+
+  public:
+    explicit tdigest(double compression = 200.0)
+      : compression_(std::max(compression, 10.0)), buffer_size_(static_cast<std::size_t>(5.0*compression_))
+    {
+      for (auto& shard : shards_)
+      {
+        shard.buffer.reserve(buffer_size_);
+        shard.centroids.reserve(buffer_size_ + static_cast<std::size_t>(compression_));
+      }
+    }
+
+    tdigest(const tdigest& other) = delete;
+    tdigest& operator=(const tdigest& other) = delete;
+
+    void record(double value)
+    {
+      if (value != value)
+      { return; }
+      shard_t& shard = shard_of_thread();
+      std::lock_guard<std::mutex> lock(shard.lock);
+      shard.buffer.push_back(value);
+      shard.count += 1.0;
+      shard.min    = std::min(shard.min, value);
+      shard.max    = std::max(shard.max, value);
+      if (shard.buffer.size() >= buffer_size_)
+      { flush(shard); }
+    }
+
+    template<typename Rep, typename Period>
+    void record(std::chrono::duration<Rep, Period> value)
+    { record(std::chrono::duration<double, std::nano>(value).count()); }
+
+    void merge(const tdigest& other)
+    {
+      const auto [count, min_val, max_val, centroids] = other.snapshot();
+      if (count == 0.0)
+      { return; }
+      shard_t& shard = shard_of_thread();
+      std::lock_guard<std::mutex> lock(shard.lock);
+      shard.centroids.insert(shard.centroids.end(), centroids.begin(), centroids.end());
+      shard.count += count;
+      shard.min    = std::min(shard.min, min_val);
+      shard.max    = std::max(shard.max, max_val);
+      flush(shard);
+    }
+
+    void reset()
+    {
+      for (auto& shard : shards_)
+      {
+        std::lock_guard<std::mutex> lock(shard.lock);
+        shard.buffer.clear();
+        shard.centroids.clear();
+        shard.count = 0.0;
+        shard.min   = std::numeric_limits<double>::infinity();
+        shard.max   = -std::numeric_limits<double>::infinity();
+      }
+    }
+
+    // (count, min, max, centroids) of all shards merged into one digest
+    std::tuple<double, double, double, std::vector<centroid>> snapshot() const
+    {
+      double count = 0.0;
+      double min_val = std::numeric_limits<double>::infinity();
+      double max_val = -min_val;
+      std::vector<centroid> centroids;
+      for (auto& shard : shards_)
+      {
+        std::lock_guard<std::mutex> lock(shard.lock);
+        centroids.insert(centroids.end(), shard.centroids.begin(), shard.centroids.end());
+        for (const double value : shard.buffer)
+        { centroids.push_back(centroid{value, 1.0}); }
+        count  += shard.count;
+        min_val = std::min(min_val, shard.min);
+        max_val = std::max(max_val, shard.max);
+      }
+      compress(centroids, compression_);
+      return std::make_tuple(count, min_val, max_val, std::move(centroids));
+    }
+
+    // value at quantile q (0-1), interpolated between centroid means
+    double quantile(double q) const
+    {
+      const auto [count, min_val, max_val, centroids] = snapshot();
+      if (centroids.empty())
+      { return std::numeric_limits<double>::quiet_NaN(); }
+
+      const double rank = std::clamp(q, 0.0, 1.0)*count;
+      double prev_rank = 0.0, prev_mean = min_val, weight_so_far = 0.0;
+      for (const auto& c : centroids)
+      {
+        const double center = weight_so_far + c.weight/2.0;
+        if (rank < center)
+        { return prev_mean + (c.mean - prev_mean)*(rank - prev_rank)/(center - prev_rank); }
+        prev_rank = center;
+        prev_mean = c.mean;
+        weight_so_far += c.weight;
+      }
+      return (count > prev_rank) ? prev_mean + (max_val - prev_mean)*(rank - prev_rank)/(count - prev_rank) : max_val;
+    }
+
+    double compression() const noexcept
+    { return compression_; }
+};
+
+inline std::size_t container_size(const tdigest& data)
+{ return static_cast<std::size_t>(data.compression()); }
+
+inline std::array<std::size_t, 1> container_shape(const tdigest& data)
+{ return std::array<std::size_t, 1>{static_cast<std::size_t>(data.compression())}; }
+
+inline std::string container_encoding(const tdigest& data)
+{ (void)data; return "tdigest"; }
+
+inline void fill_zmq_buffer(const tdigest& data, zmq::message_t& buffer)
+{
+  const auto [count, min_val, max_val, centroids] = data.snapshot();
+  const std::array<double, 3> info{count, min_val, max_val};
+  buffer.rebuild(sizeof(info) + centroids.size()*sizeof(tdigest::centroid));
+  char * ptr = static_cast<char*>(buffer.data());
+  std::memcpy(ptr, info.data(), sizeof(info));
+  if (!centroids.empty())
+  { std::memcpy(ptr + sizeof(info), centroids.data(), centroids.size()*sizeof(tdigest::centroid)); }
+}
+
+#endif
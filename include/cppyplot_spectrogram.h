@@ -0,0 +1,213 @@
+#ifndef _CPPYPLOT_SPECTROGRAM_H_
+#define _CPPYPLOT_SPECTROGRAM_H_
+
+/*
+  * Streaming spectrogram (STFT) of a live signal
+  * push() buffers the samples and computes the column of every frame (fft_size samples, hop apart, symmetric Hann window as np.hanning)
+  * as soon as it is complete, no sample is transformed twice. _p(spec) sends the columns computed since the last send,
+  * python side appends them to a rolling waterfall image of the last 'history' columns.
+  * Columns follow matplotlib specgram: psd (one sided, per Hz), magnitude (|X|/sum(window)) or decibel (10*log10(psd)).
+  * At most 'history' columns are kept while the spectrogram is not sent. push() and sending may run on different threads.
+  * payload: [first_column, n_columns] (uint64) | sample_rate (float64) | columns (float32, n_columns x (fft_size/2 + 1))
+*/
+enum class spectrum_scale { psd, magnitude, decibel };
+
+class spectrogram{
+  public:
+    using value_type = float;
+
+  private:
+    std::size_t         fft_size_;
+    std::size_t         hop_;
+    std::size_t         history_;
+    double              sample_rate_;
+    spectrum_scale      scale_;
+    std::vector<double> window_;
+    double              window_sum_   = 0.0;
+    double              window_power_ = 0.0;
+    std::vector<double> input_;              // samples not consumed by a complete frame yet
+    std::uint64_t       n_columns_ = 0u;     // columns computed so far
+    // pending columns are handed over when the spectrogram is sent
+    mutable std::vector<float> columns_;     // row major (pending x bins)
+    mutable std::uint64_t      first_column_ = 0u;
+    mutable std::mutex         lock_;
+
+    float scaled(double power, std::size_t bin) const noexcept
+    {
+      if (scale_ == spectrum_scale::magnitude)
+      { return static_cast<float>(std::sqrt(power)/window_sum_); }
+
+      // one sided density, DC and Nyquist bins have no mirrored counterpart
+      double psd = power/(sample_rate_*window_power_);
+      psd *= ((bin == 0u) || (2u*bin == fft_size_)) ? 1.0 : 2.0;
+      return static_cast<float>((scale_ == spectrum_scale::decibel) ? 10.0*std::log10(psd) : psd);
+    }
+
+    // columns of 'n_frames' frames starting at 'samples', two real frames share one complex FFT
+    void transform(const double* samples, std::size_t n_frames, float* out) const
+    {
+      const std::size_t n_bins = bins();
+      parallel_for(0u, (n_frames + 1u)/2u, [&](std::size_t begin, std::size_t end)
+      {
+        std::vector<std::complex<double>> buffer(fft_size_);
+        for (std::size_t pair = begin; pair < end; pair++)
+        {
+          const std::size_t frame  = 2u*pair;
+          const bool has_second    = (frame + 1u) < n_frames;
+          const double * first     = samples + frame*hop_;
+          const double * second    = has_second ? (first + hop_) : first;
+          for (std::size_t i = 0u; i < fft_size_; i++)
+          { buffer[i] = std::complex<double>(first[i]*window_[i], has_second ? second[i]*window_[i] : 0.0); }
+          fft(buffer.data(), fft_size_, false);
+
+          // Z = FFT(a + ib): A[k] = (Z[k] + conj(Z[N-k]))/2, B[k] = (Z[k] - conj(Z[N-k]))/2i
+          for (std::size_t k = 0u; k < n_bins; k++)
+          {
+            const std::complex<double> z        = buffer[k];
+            const std::complex<double> z_mirror = std::conj(buffer[(fft_size_ - k) & (fft_size_ - 1u)]);
+            out[frame*n_bins + k] = scaled(std::norm(0.5*(z + z_mirror)), k);
+            if (has_second)
+            { out[(frame + 1u)*n_bins + k] = scaled(std::norm(0.5*(z - z_mirror)), k); }
+          }
+        }
+      }, 16u);
+    }
+
+    // columns of the complete frames in the input buffer, only the last 'history' columns are computed
+    void consume()
+    {
+      if (input_.size() < fft_size_)
+      { return; }
+
+      const std::size_t n_bins   = bins();
+      const std::size_t n_frames = (input_.size() - fft_size_)/hop_ + 1u;
+      const std::size_t n_keep   = std::min(n_frames, history_);
+      const std::size_t skipped  = n_frames - n_keep;
+      if (skipped > 0u)
+      {
+        columns_.clear();
+        first_column_ = n_columns_ + skipped;
+      }
+
+      const std::size_t offset = columns_.size();
+      columns_.resize(offset + n_keep*n_bins);
+      transform(input_.data() + skipped*hop_, n_keep, columns_.data() + offset);
+      input_.erase(input_.begin(), input_.begin() + static_cast<std::ptrdiff_t>(n_frames*hop_));
+      n_columns_ += n_frames;
+
+      const std::size_t pending = columns_.size()/n_bins;
+      if (pending > history_)
+      {
+        columns_.erase(columns_.begin(), columns_.begin() + static_cast<std::ptrdiff_t>((pending - history_)*n_bins));
+        first_column_ += pending - history_;
+      }
+    }
+
+  public:
+    // fft_size is rounded up to a power of two, hop is clamped to [1, fft_size]
+    explicit spectrogram(std::size_t fft_size = 256u, std::size_t hop = 128u, double sample_rate = 1.0,
+                         std::size_t history = 512u, spectrum_scale scale = spectrum_scale::decibel)
+      : fft_size_(next_pow2(std::max<std::size_t>(fft_size, 2u))),
+        hop_(std::clamp<std::size_t>(hop, 1u, fft_size_)),
+        history_(std::max<std::size_t>(history, 1u)),
+        sample_rate_(sample_rate),
+        scale_(scale)
+    {
+      const double pi = 3.14159265358979323846;
+      // symmetric like np.hanning, mlab.specgram's default window
+      window_.resize(fft_size_);
+      for (std::size_t i = 0u; i < fft_size_; i++)
+      {
+        window_[i]     = 0.5 - 0.5*std::cos(2.0*pi*static_cast<double>(i)/static_cast<double>(fft_size_ - 1u));
+        window_sum_   += window_[i];
+        window_power_ += window_[i]*window_[i];
+      }
+    }
+
+    template<typename T>
+    void push(const T* samples, std::size_t n_samples)
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      input_.insert(input_.end(), samples, samples + n_samples);
+      consume();
+    }
+
+    template<typename T>
+    auto push(const T sample) -> typename std::enable_if<std::is_arithmetic_v<T>, void>::type
+    {
+      const double value = static_cast<double>(sample);
+      push(&value, 1u);
+    }
+
+    // contiguous containers (std::vector, std::array, Eigen vectors)
+    template<typename Container>
+    auto push(const Container& samples) -> typename std::enable_if<!std::is_arithmetic_v<Container>, void>::type
+    { push(samples.data(), static_cast<std::size_t>(samples.size())); }
+
+    // hands the pending columns over as (index of the first column, columns)
+    std::pair<std::uint64_t, std::vector<float>> take_columns() const
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      std::vector<float> pending;
+      pending.swap(columns_);
+      const std::uint64_t first = first_column_;
+      first_column_ += pending.size()/bins();
+      return std::make_pair(first, std::move(pending));
+    }
+
+    void reset()
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      input_.clear();
+      columns_.clear();
+      n_columns_    = 0u;
+      first_column_ = 0u;
+    }
+
+    std::size_t bins() const noexcept
+    { return fft_size_/2u + 1u; }
+
+    std::size_t fft_size() const noexcept
+    { return fft_size_; }
+
+    std::size_t hop() const noexcept
+    { return hop_; }
+
+    std::size_t history() const noexcept
+    { return history_; }
+
+    double sample_rate() const noexcept
+    { return sample_rate_; }
+
+    spectrum_scale scale() const noexcept
+    { return scale_; }
+};
+
+inline std::size_t container_size(const spectrogram& data)
+{ return data.bins(); }
+
+inline std::array<std::size_t, 1> container_shape(const spectrogram& data)
+{ return std::array<std::size_t, 1>{data.bins()}; }
+
+inline std::string container_encoding(const spectrogram& data)
+{
+  const char* scale = (data.scale() == spectrum_scale::psd) ? "psd" :
+                      (data.scale() == spectrum_scale::magnitude) ? "magnitude" : "decibel";
+  return "stft:" + std::to_string(data.fft_size()) + "," + std::to_string(data.hop()) + ","
+                 + std::to_string(data.history()) + "," + scale;
+}
+
+inline void fill_zmq_buffer(const spectrogram& data, zmq::message_t& buffer)
+{
+  const auto [first_column, columns] = data.take_columns();
+  const std::array<std::uint64_t, 2> info{first_column, columns.size()/data.bins()};
+  const double sample_rate = data.sample_rate();
+  buffer.rebuild(sizeof(info) + sizeof(sample_rate) + columns.size()*sizeof(float));
+  char * ptr = static_cast<char*>(buffer.data());
+  std::memcpy(ptr, info.data(), sizeof(info));
+  std::memcpy(ptr + sizeof(info), &sample_rate, sizeof(sample_rate));
+  if (!columns.empty())
+  { std::memcpy(ptr + sizeof(info) + sizeof(sample_rate), columns.data(), columns.size()*sizeof(float)); }
+}
+
+#endif
@@ -0,0 +1,704 @@
+#ifndef _CPPYPLOT_STATS_H_
+#define _CPPYPLOT_STATS_H_
+
+/*
+  * Sample access for the binning kernels
+  * 1D containers hold one sample per element, 2D containers (N x D) hold one sample per row
+*/
+template<typename T>
+inline std::size_t sample_count(const std::vector<T>& data)
+{ return data.size(); }
+
+template<typename T>
+inline std::size_t sample_dims(const std::vector<T>& data)
+{ (void)data; return 1u; }
+
+template<typename T>
+inline double sample_at(const std::vector<T>& data, std::size_t i, std::size_t col)
+{ (void)col; return static_cast<double>(data[i]); }
+
+template<typename T, std::size_t N>
+inline std::size_t sample_count(const std::array<T, N>& data)
+{ (void)data; return N; }
+
+template<typename T, std::size_t N>
+inline std::size_t sample_dims(const std::array<T, N>& data)
+{ (void)data; return 1u; }
+
+template<typename T, std::size_t N>
+inline double sample_at(const std::array<T, N>& data, std::size_t i, std::size_t col)
+{ (void)col; return static_cast<double>(data[i]); }
+
+template<typename T>
+inline std::size_t sample_count(const std::vector<std::vector<T>>& data)
+{ return data.size(); }
+
+template<typename T>
+inline std::size_t sample_dims(const std::vector<std::vector<T>>& data)
+{ return data.empty() ? 0u : data[0].size(); }
+
+template<typename T>
+inline double sample_at(const std::vector<std::vector<T>>& data, std::size_t i, std::size_t col)
+{ return static_cast<double>(data[i][col]); }
+
+// vector of fixed size rows, common layout of point clouds
+template<typename T, std::size_t M>
+inline std::size_t sample_count(const std::vector<std::array<T, M>>& data)
+{ return data.size(); }
+
+template<typename T, std::size_t M>
+inline std::size_t sample_dims(const std::vector<std::array<T, M>>& data)
+{ (void)data; return M; }
+
+template<typename T, std::size_t M>
+inline double sample_at(const std::vector<std::array<T, M>>& data, std::size_t i, std::size_t col)
+{ return static_cast<double>(data[i][col]); }
+
+template<typename T, std::size_t N, std::size_t M>
+inline std::size_t sample_count(const std::array<std::array<T, M>, N>& data)
+{ (void)data; return N; }
+
+template<typename T, std::size_t N, std::size_t M>
+inline std::size_t sample_dims(const std::array<std::array<T, M>, N>& data)
+{ (void)data; return M; }
+
+template<typename T, std::size_t N, std::size_t M>
+inline double sample_at(const std::array<std::array<T, M>, N>& data, std::size_t i, std::size_t col)
+{ return static_cast<double>(data[i][col]); }
+
+#if defined (EIGEN_AVAILABLE)
+template<typename Derived>
+inline std::size_t sample_count(const Eigen::EigenBase<Derived>& data)
+{ return ((data.rows() == 1) || (data.cols() == 1)) ? data.size() : data.rows(); }
+
+template<typename Derived>
+inline std::size_t sample_dims(const Eigen::EigenBase<Derived>& data)
+{ return ((data.rows() == 1) || (data.cols() == 1)) ? 1u : static_cast<std::size_t>(data.cols()); }
+
+template<typename Derived>
+inline double sample_at(const Eigen::EigenBase<Derived>& data, std::size_t i, std::size_t col)
+{
+  if ((data.rows() == 1) || (data.cols() == 1))
+  { return static_cast<double>(data.derived().coeff(i)); }
+  return static_cast<double>(data.derived().coeff(i, col));
+}
+#endif
+
+// placeholder for bin ranges that are computed from the data
+constexpr double AUTO_RANGE = std::numeric_limits<double>::quiet_NaN();
+
+/* min/max of the finite samples of column 'col', (0, 0) if there are none */
+template<typename T>
+std::pair<double, double> sample_min_max(const T& data, std::size_t col)
+{
+  double min_val = std::numeric_limits<double>::infinity();
+  double max_val = -min_val;
+  std::mutex merge_lock;
+  parallel_for(0u, sample_count(data), [&](std::size_t begin, std::size_t end)
+  {
+    double chunk_min = std::numeric_limits<double>::infinity();
+    double chunk_max = -chunk_min;
+    for (std::size_t i = begin; i < end; i++)
+    {
+      const double value     = sample_at(data, i, col);
+      const bool   is_finite = (value - value) == 0.0;
+      chunk_min = (is_finite && (value < chunk_min)) ? value : chunk_min;
+      chunk_max = (is_finite && (value > chunk_max)) ? value : chunk_max;
+    }
+    std::lock_guard<std::mutex> lock(merge_lock);
+    min_val = std::min(min_val, chunk_min);
+    max_val = std::max(max_val, chunk_max);
+  }, 1u << 16u);
+  return (min_val <= max_val) ? std::make_pair(min_val, max_val) : std::make_pair(0.0, 0.0);
+}
+
+/*
+  * Equal width bins over [first, last] with the numpy.histogram semantics:
+  * bin i holds edges[i] <= x < edges[i+1], the last bin also holds x == last, samples outside (and NaN) are dropped.
+  * An empty range is widened by 0.5 on both sides like numpy does.
+*/
+class bin_axis{
+  private:
+    std::vector<double> edges_;
+    double              norm_;
+    std::size_t         bins_;
+
+  public:
+    bin_axis(std::size_t bins, double first, double last)
+      : bins_(std::max<std::size_t>(bins, 1u))
+    {
+      if (!(first < last))
+      {
+        first -= 0.5;
+        last  += 0.5;
+      }
+      const double step = (last - first)/static_cast<double>(bins_);
+      edges_.resize(bins_ + 1u);
+      for (std::size_t i = 0u; i < bins_; i++)
+      { edges_[i] = first + static_cast<double>(i)*step; }
+      edges_[bins_] = last;
+      norm_ = static_cast<double>(bins_)/(last - first);
+    }
+
+    // bin of the sample, bins() if it falls outside
+    std::size_t index(double value) const
+    {
+      if (!((value >= edges_.front()) && (value <= edges_.back())))
+      { return bins_; }
+
+      // the scaled index can be one off at the edges due to rounding, the edges decide
+      std::size_t idx = std::min(static_cast<std::size_t>((value - edges_.front())*norm_), bins_ - 1u);
+      if (value < edges_[idx])
+      { idx--; }
+      else if ((idx + 1u < bins_) && (value >= edges_[idx + 1u]))
+      { idx++; }
+      return idx;
+    }
+
+    std::size_t bins() const noexcept
+    { return bins_; }
+
+    const std::vector<double>& edges() const noexcept
+    { return edges_; }
+};
+
+template<typename T>
+inline bin_axis make_bin_axis(const T& data, std::size_t col, std::size_t bins, double first, double last)
+{
+  if (std::isnan(first) || std::isnan(last))
+  {
+    const auto [min_val, max_val] = sample_min_max(data, col);
+    first = std::isnan(first) ? min_val : first;
+    last  = std::isnan(last)  ? max_val : last;
+  }
+  return bin_axis(bins, first, last);
+}
+
+/*
+  * Counts the samples per cell, cell_of(i) returns the cell of sample i or n_cells to drop it.
+  * Each thread fills its own counts which are summed at the end.
+*/
+template<typename CellFunc>
+std::vector<std::int64_t> count_cells(std::size_t n_samples, std::size_t n_cells, CellFunc&& cell_of)
+{
+  std::vector<std::int64_t> counts(n_cells, 0);
+  std::mutex merge_lock;
+  parallel_for(0u, n_samples, [&](std::size_t begin, std::size_t end)
+  {
+    // last slot collects the dropped samples, keeps the counting loop free of branches
+    std::vector<std::int64_t> local(n_cells + 1u, 0);
+    for (std::size_t i = begin; i < end; i++)
+    { local[cell_of(i)]++; }
+
+    std::lock_guard<std::mutex> lock(merge_lock);
+    for (std::size_t c = 0u; c < n_cells; c++)
+    { counts[c] += local[c]; }
+  }, 1u << 16u);
+  return counts;
+}
+
+/*
+  * Histogram computed on C++ side, only bin edges and counts are sent
+  * python side gets the numpy.histogram tuple (counts, edges), plt.stairs(*x) draws it.
+  * range defaults to the min/max of the finite samples.
+  * payload: edges (double x bins+1) | counts (int64 x bins)
+*/
+template<typename T>
+struct histogram{
+  using value_type = std::int64_t;
+  const T&    data;
+  std::size_t bins;
+  double      first;
+  double      last;
+};
+
+template<typename T>
+inline auto _hist(std::pair<std::string, T&>&& arg, std::size_t bins = 10u,
+                  double first = AUTO_RANGE, double last = AUTO_RANGE)
+{ return std::make_pair(arg.first, histogram<T>{arg.second, std::max<std::size_t>(bins, 1u), first, last}); }
+
+template<typename T>
+inline std::size_t container_size(const histogram<T>& data)
+{ return data.bins; }
+
+template<typename T>
+inline std::array<std::size_t, 1> container_shape(const histogram<T>& data)
+{ return std::array<std::size_t, 1>{data.bins}; }
+
+template<typename T>
+inline std::string container_encoding(const histogram<T>& data)
+{ return "hist:" + std::to_string(data.bins); }
+
+template<typename T>
+void fill_zmq_buffer(const histogram<T>& data, zmq::message_t& buffer)
+{
+  const bin_axis axis = make_bin_axis(data.data, 0u, data.bins, data.first, data.last);
+  const auto counts   = count_cells(sample_count(data.data), axis.bins(),
+                                    [&](std::size_t i){ return axis.index(sample_at(data.data, i, 0u)); });
+
+  const std::size_t edge_bytes = axis.edges().size()*sizeof(double);
+  buffer.rebuild(edge_bytes + counts.size()*sizeof(std::int64_t));
+  char * ptr = static_cast<char*>(buffer.data());
+  std::memcpy(ptr, axis.edges().data(), edge_bytes);
+  std::memcpy(ptr + edge_bytes, counts.data(), counts.size()*sizeof(std::int64_t));
+}
+
+/*
+  * 2D histogram of N x 2 containers (x, y per row)
+  * python side gets the numpy.histogram2d tuple (counts, x_edges, y_edges), counts has shape (x_bins, y_bins)
+  * so plt.pcolormesh(x[1], x[2], x[0].T) draws it. extent is (xmin, xmax, ymin, ymax), defaults to the data range.
+  * payload: x_edges (double x x_bins+1) | y_edges (double x y_bins+1) | counts (int64 x x_bins*y_bins)
+*/
+template<typename T>
+struct histogram2d{
+  using value_type = std::int64_t;
+  const T&              data;
+  std::size_t           x_bins;
+  std::size_t           y_bins;
+  std::array<double, 4> extent;
+};
+
+template<typename T>
+inline auto _hist2d(std::pair<std::string, T&>&& arg, std::size_t x_bins = 10u, std::size_t y_bins = 10u,
+                    const std::array<double, 4>& extent = {AUTO_RANGE, AUTO_RANGE, AUTO_RANGE, AUTO_RANGE})
+{
+  return std::make_pair(arg.first, histogram2d<T>{arg.second, std::max<std::size_t>(x_bins, 1u),
+                                                  std::max<std::size_t>(y_bins, 1u), extent});
+}
+
+template<typename T>
+inline std::size_t container_size(const histogram2d<T>& data)
+{ return data.x_bins*data.y_bins; }
+
+template<typename T>
+inline std::array<std::size_t, 2> container_shape(const histogram2d<T>& data)
+{ return std::array<std::size_t, 2>{data.x_bins, data.y_bins}; }
+
+template<typename T>
+inline std::string container_encoding(const histogram2d<T>& data)
+{ return "hist2d:" + std::to_string(data.x_bins) + "," + std::to_string(data.y_bins); }
+
+template<typename T>
+void fill_zmq_buffer(const histogram2d<T>& data, zmq::message_t& buffer)
+{
+  const bin_axis x_axis = make_bin_axis(data.data, 0u, data.x_bins, data.extent[0], data.extent[1]);
+  const bin_axis y_axis = make_bin_axis(data.data, 1u, data.y_bins, data.extent[2], data.extent[3]);
+  const std::size_t n_cells = x_axis.bins()*y_axis.bins();
+  const auto counts = count_cells(sample_count(data.data), n_cells, [&](std::size_t i)
+  {
+    const std::size_t x_idx = x_axis.index(sample_at(data.data, i, 0u));
+    const std::size_t y_idx = y_axis.index(sample_at(data.data, i, 1u));
+    return ((x_idx < x_axis.bins()) && (y_idx < y_axis.bins())) ? x_idx*y_axis.bins() + y_idx : n_cells;
+  });
+
+  const std::size_t x_bytes = x_axis.edges().size()*sizeof(double);
+  const std::size_t y_bytes = y_axis.edges().size()*sizeof(double);
+  buffer.rebuild(x_bytes + y_bytes + counts.size()*sizeof(std::int64_t));
+  char * ptr = static_cast<char*>(buffer.data());
+  std::memcpy(ptr, x_axis.edges().data(), x_bytes);
+  std::memcpy(ptr + x_bytes, y_axis.edges().data(), y_bytes);
+  std::memcpy(ptr + x_bytes + y_bytes, counts.data(), counts.size()*sizeof(std::int64_t));
+}
+
+/*
+  * Hexagonal binning of N x 2 containers, same grid and assignment as matplotlib's Axes.hexbin
+  * python side gets (x, y, counts) of all hexagons (empty ones included) and '<name>_hexbin' keyword arguments,
+  * plt.hexbin(*x, **x_hexbin) draws the same plot as plt.hexbin on the samples.
+  * grid_x hexagons along x, int(grid_x/sqrt(3)) along y, extent defaults to the data range.
+  * payload: extent (double x 4) | counts (int64, (grid_x+1)*(grid_y+1) + grid_x*grid_y)
+*/
+template<typename T>
+struct hexbinned{
+  using value_type = std::int64_t;
+  const T&              data;
+  std::size_t           grid_x;
+  std::size_t           grid_y;
+  std::array<double, 4> extent;
+};
+
+template<typename T>
+inline auto _hexbin(std::pair<std::string, T&>&& arg, std::size_t grid_x = 100u,
+                    const std::array<double, 4>& extent = {AUTO_RANGE, AUTO_RANGE, AUTO_RANGE, AUTO_RANGE})
+{
+  const std::size_t grid_y = static_cast<std::size_t>(static_cast<double>(grid_x)/std::sqrt(3.0));
+  return std::make_pair(arg.first, hexbinned<T>{arg.second, std::max<std::size_t>(grid_x, 1u),
+                                                std::max<std::size_t>(grid_y, 1u), extent});
+}
+
+template<typename T>
+inline std::size_t container_size(const hexbinned<T>& data)
+{ return (data.grid_x + 1u)*(data.grid_y + 1u) + data.grid_x*data.grid_y; }
+
+template<typename T>
+inline std::array<std::size_t, 1> container_shape(const hexbinned<T>& data)
+{ return std::array<std::size_t, 1>{container_size(data)}; }
+
+template<typename T>
+inline std::string container_encoding(const hexbinned<T>& data)
+{ return "hexbin:" + std::to_string(data.grid_x) + "," + std::to_string(data.grid_y); }
+
+/* matplotlib's mtransforms._nonsingular(vmin, vmax, expander=0.1) */
+inline std::pair<double, double> hexbin_nonsingular(double vmin, double vmax)
+{
+  const double max_abs = std::max(std::abs(vmin), std::abs(vmax));
+  if (max_abs < 1e6*std::numeric_limits<double>::min()/1e-15)
+  { return std::make_pair(-0.1, 0.1); }
+  if ((vmax - vmin) <= max_abs*1e-15)
+  { return std::make_pair(vmin - 0.1*std::abs(vmin), vmax + 0.1*std::abs(vmax)); }
+  return std::make_pair(vmin, vmax);
+}
+
+template<typename T>
+void fill_zmq_buffer(const hexbinned<T>& data, zmq::message_t& buffer)
+{
+  std::array<double, 4> extent = data.extent;
+  for (std::size_t col = 0u; col < 2u; col++)
+  {
+    double& vmin = extent[2u*col];
+    double& vmax = extent[2u*col + 1u];
+    if (std::isnan(vmin) || std::isnan(vmax))
+    {
+      const auto [min_val, max_val] = sample_min_max(data.data, col);
+      std::tie(vmin, vmax) = hexbin_nonsingular(std::isnan(vmin) ? min_val : vmin, std::isnan(vmax) ? max_val : vmax);
+    }
+  }
+
+  // two interleaved lattices, centers of the first at integer grid positions, of the second at +0.5
+  const std::size_t nx1 = data.grid_x + 1u, ny1 = data.grid_y + 1u;
+  const std::size_t nx2 = data.grid_x,      ny2 = data.grid_y;
+  const std::size_t n_cells = nx1*ny1 + nx2*ny2;
+
+  const double padding = 1e-9*(extent[1] - extent[0]);
+  const double xmin    = extent[0] - padding;
+  const double sx      = ((extent[1] + padding) - xmin)/static_cast<double>(nx2);
+  const double ymin    = extent[2];
+  const double sy      = (extent[3] - ymin)/static_cast<double>(ny2);
+
+  const auto counts = count_cells(sample_count(data.data), n_cells, [&](std::size_t i)
+  {
+    const double ix = (sample_at(data.data, i, 0u) - xmin)/sx;
+    const double iy = (sample_at(data.data, i, 1u) - ymin)/sy;
+    // np.round rounds half to even, same as nearbyint in the default rounding mode
+    const double ix1 = std::nearbyint(ix), iy1 = std::nearbyint(iy);
+    const double ix2 = std::floor(ix),     iy2 = std::floor(iy);
+    const double d1  = (ix - ix1)*(ix - ix1) + 3.0*(iy - iy1)*(iy - iy1);
+    const double d2  = (ix - ix2 - 0.5)*(ix - ix2 - 0.5) + 3.0*(iy - iy2 - 0.5)*(iy - iy2 - 0.5);
+
+    // comparisons are false for NaN, drops those samples as well
+    if (d1 < d2)
+    {
+      const bool inside =    (ix1 >= 0.0) && (ix1 < static_cast<double>(nx1))
+                          && (iy1 >= 0.0) && (iy1 < static_cast<double>(ny1));
+      return inside ? static_cast<std::size_t>(ix1)*ny1 + static_cast<std::size_t>(iy1) : n_cells;
+    }
+    const bool inside =    (ix2 >= 0.0) && (ix2 < static_cast<double>(nx2))
+                        && (iy2 >= 0.0) && (iy2 < static_cast<double>(ny2));
+    return inside ? nx1*ny1 + static_cast<std::size_t>(ix2)*ny2 + static_cast<std::size_t>(iy2) : n_cells;
+  });
+
+  buffer.rebuild(sizeof(extent) + counts.size()*sizeof(std::int64_t));
+  char * ptr = static_cast<char*>(buffer.data());
+  std::memcpy(ptr, extent.data(), sizeof(extent));
+  std::memcpy(ptr + sizeof(extent), counts.data(), counts.size()*sizeof(std::int64_t));
+}
+
+/*
+  * In place radix-2 FFT, size of 'values' has to be a power of two.
+  * inverse does not scale by 1/size.
+*/
+inline void fft(std::complex<double>* values, std::size_t size, bool inverse)
+{
+  for (std::size_t i = 1u, j = 0u; i < size; i++)
+  {
+    std::size_t bit = size >> 1u;
+    for (; j & bit; bit >>= 1u)
+    { j ^= bit; }
+    j ^= bit;
+    if (i < j)
+    { std::swap(values[i], values[j]); }
+  }
+
+  const double pi = 3.14159265358979323846;
+  for (std::size_t len = 2u; len <= size; len <<= 1u)
+  {
+    const double angle = (inverse ? 2.0 : -2.0)*pi/static_cast<double>(len);
+    const std::complex<double> w_len(std::cos(angle), std::sin(angle));
+    for (std::size_t start = 0u; start < size; start += len)
+    {
+      std::complex<double> w(1.0, 0.0);
+      for (std::size_t k = 0u; k < len/2u; k++)
+      {
+        const std::complex<double> even = values[start + k];
+        const std::complex<double> odd  = values[start + k + len/2u]*w;
+        values[start + k]           = even + odd;
+        values[start + k + len/2u]  = even - odd;
+        w *= w_len;
+      }
+    }
+  }
+}
+
+/* 2D FFT of a row major (rows x cols) grid, rows and columns are transformed in parallel */
+inline void fft2d(std::vector<std::complex<double>>& values, std::size_t rows, std::size_t cols, bool inverse)
+{
+  parallel_for(0u, rows, [&](std::size_t begin, std::size_t end)
+  {
+    for (std::size_t r = begin; r < end; r++)
+    { fft(values.data() + r*cols, cols, inverse); }
+  }, 8u);
+
+  parallel_for(0u, cols, [&](std::size_t begin, std::size_t end)
+  {
+    std::vector<std::complex<double>> column(rows);
+    for (std::size_t c = begin; c < end; c++)
+    {
+      for (std::size_t r = 0u; r < rows; r++)
+      { column[r] = values[r*cols + c]; }
+      fft(column.data(), rows, inverse);
+      for (std::size_t r = 0u; r < rows; r++)
+      { values[r*cols + c] = column[r]; }
+    }
+  }, 8u);
+}
+
+inline std::size_t next_pow2(std::size_t value)
+{
+  std::size_t pow2 = 1u;
+  while (pow2 < value)
+  { pow2 <<= 1u; }
+  return pow2;
+}
+
+/*
+  * Mean and covariance (ddof=1) of the samples whose columns [0, dims) are all finite
+  * returns (n_samples, mean, covariance), covariance is row major (dims x dims)
+*/
+template<typename T>
+std::tuple<std::size_t, std::array<double, 2>, std::array<double, 4>> sample_covariance(const T& data, std::size_t dims)
+{
+  auto is_valid = [&](std::size_t i)
+  {
+    bool valid = true;
+    for (std::size_t d = 0u; d < dims; d++)
+    {
+      const double value = sample_at(data, i, d);
+      valid = valid && ((value - value) == 0.0);
+    }
+    return valid;
+  };
+
+  std::size_t n_valid = 0u;
+  std::array<double, 2> sum{};
+  std::mutex merge_lock;
+  parallel_for(0u, sample_count(data), [&](std::size_t begin, std::size_t end)
+  {
+    std::size_t chunk_n = 0u;
+    std::array<double, 2> chunk_sum{};
+    for (std::size_t i = begin; i < end; i++)
+    {
+      if (!is_valid(i))
+      { continue; }
+      chunk_n++;
+      for (std::size_t d = 0u; d < dims; d++)
+      { chunk_sum[d] += sample_at(data, i, d); }
+    }
+    std::lock_guard<std::mutex> lock(merge_lock);
+    n_valid += chunk_n;
+    for (std::size_t d = 0u; d < dims; d++)
+    { sum[d] += chunk_sum[d]; }
+  }, 1u << 16u);
+
+  std::array<double, 2> mean{};
+  std::array<double, 4> cov{};
+  if (n_valid < 2u)
+  { return std::make_tuple(n_valid, mean, cov); }
+  for (std::size_t d = 0u; d < dims; d++)
+  { mean[d] = sum[d]/static_cast<double>(n_valid); }
+
+  // second pass around the mean, single pass sum of squares loses precision
+  parallel_for(0u, sample_count(data), [&](std::size_t begin, std::size_t end)
+  {
+    std::array<double, 4> chunk_cov{};
+    for (std::size_t i = begin; i < end; i++)
+    {
+      if (!is_valid(i))
+      { continue; }
+      for (std::size_t a = 0u; a < dims; a++)
+      {
+        const double da = sample_at(data, i, a) - mean[a];
+        for (std::size_t b = 0u; b < dims; b++)
+        { chunk_cov[a*dims + b] += da*(sample_at(data, i, b) - mean[b]); }
+      }
+    }
+    std::lock_guard<std::mutex> lock(merge_lock);
+    for (std::size_t k = 0u; k < dims*dims; k++)
+    { cov[k] += chunk_cov[k]; }
+  }, 1u << 16u);
+
+  for (std::size_t k = 0u; k < dims*dims; k++)
+  { cov[k] /= static_cast<double>(n_valid - 1u); }
+  return std::make_tuple(n_valid, mean, cov);
+}
+
+/*
+  * Gaussian kernel density estimate on a regular grid (binned KDE)
+  * Samples are linearly binned onto the grid and the bin weights are convolved with the gaussian kernel 
+  * through zero padded FFTs, the cost is O(n + grid*log(grid)) instead of O(n*grid) for direct evaluation.
+  * Bandwidth follows seaborn's kdeplot: scipy gaussian_kde with Scott's rule (covariance*(n^(-1/(d+4))*bw_adjust)^2),
+  * grid spans [min - cut*bw, max + cut*bw] per dimension where bw is the kernel standard deviation.
+  * Python side gets (grid, density) for 1D, plt.plot(*x) draws it, 
+  * and (x_grid, y_grid, density) with density of shape (y, x) for 2D, plt.contour(*x) draws it.
+  * payload: 1D: grid (double x size) | density (double x size)
+  *          2D: x_grid (double x size) | y_grid (double x size) | density (double x size*size)
+*/
+template<typename T>
+struct kde_encoded{
+  using value_type = double;
+  const T&    data;
+  std::size_t dims;
+  std::size_t grid_size;
+  double      bw_adjust;
+  double      cut;
+};
+
+template<typename T>
+inline auto _kde(std::pair<std::string, T&>&& arg, std::size_t grid_size = 200u, double bw_adjust = 1.0, double cut = 3.0)
+{ return std::make_pair(arg.first, kde_encoded<T>{arg.second, 1u, std::max<std::size_t>(grid_size, 2u), bw_adjust, cut}); }
+
+template<typename T>
+inline auto _kde2d(std::pair<std::string, T&>&& arg, std::size_t grid_size = 128u, double bw_adjust = 1.0, double cut = 3.0)
+{ return std::make_pair(arg.first, kde_encoded<T>{arg.second, 2u, std::max<std::size_t>(grid_size, 2u), bw_adjust, cut}); }
+
+template<typename T>
+inline std::size_t container_size(const kde_encoded<T>& data)
+{ return (data.dims == 1u) ? data.grid_size : data.grid_size*data.grid_size; }
+
+template<typename T>
+inline std::array<std::size_t, 2> container_shape(const kde_encoded<T>& data)
+{ return std::array<std::size_t, 2>{(data.dims == 1u) ? 1u : data.grid_size, data.grid_size}; }
+
+template<typename T>
+inline std::string container_encoding(const kde_encoded<T>& data)
+{ return ((data.dims == 1u) ? "kde:" : "kde2d:") + std::to_string(data.grid_size); }
+
+template<typename T>
+void fill_zmq_buffer(const kde_encoded<T>& data, zmq::message_t& buffer)
+{
+  const std::size_t dims = data.dims;
+  const std::size_t size = data.grid_size;
+  auto [n_valid, mean, cov] = sample_covariance(data.data, dims);
+  (void)mean;
+
+  const double factor = std::pow(static_cast<double>(std::max<std::size_t>(n_valid, 1u)), -1.0/static_cast<double>(dims + 4u))*data.bw_adjust;
+  for (auto& value : cov)
+  { value *= factor*factor; }
+  const double det = (dims == 1u) ? cov[0] : cov[0]*cov[3] - cov[1]*cov[2];
+
+  // grids, the density stays zero for less than two samples or a singular covariance
+  std::vector<std::vector<double>> grids(dims, std::vector<double>(size, 0.0));
+  std::array<double, 2> lo{}, step{1.0, 1.0};
+  for (std::size_t d = 0u; d < dims; d++)
+  {
+    const auto [min_val, max_val] = sample_min_max(data.data, d);
+    const double bw = std::sqrt(std::max(cov[d*dims + d], 0.0));
+    lo[d]   = min_val - data.cut*bw;
+    step[d] = ((max_val + data.cut*bw) - lo[d])/static_cast<double>(size - 1u);
+    for (std::size_t i = 0u; i < size; i++)
+    { grids[d][i] = lo[d] + static_cast<double>(i)*step[d]; }
+  }
+
+  std::vector<double> density(container_size(data), 0.0);
+  if ((n_valid >= 2u) && (det > 0.0) && (step[0] > 0.0) && (step[1] > 0.0))
+  {
+    // linear binning, every sample spreads its unit weight over the 2 (1D) or 4 (2D) nearest grid points
+    const std::size_t y_size = (dims == 1u) ? 1u : size;
+    std::vector<double> weights(size*y_size, 0.0);
+    std::mutex merge_lock;
+    parallel_for(0u, sample_count(data.data), [&](std::size_t begin, std::size_t end)
+    {
+      std::vector<double> local(weights.size(), 0.0);
+      for (std::size_t i = begin; i < end; i++)
+      {
+        std::array<std::size_t, 2> idx{};
+        std::array<double, 2> frac{};
+        bool valid = true;
+        for (std::size_t d = 0u; d < dims; d++)
+        {
+          const double pos = (sample_at(data.data, i, d) - lo[d])/step[d];
+          valid  = valid && (pos >= 0.0) && (pos <= static_cast<double>(size - 1u));
+          const double base = valid ? std::min(std::floor(pos), static_cast<double>(size - 2u)) : 0.0;
+          idx[d]  = static_cast<std::size_t>(base);
+          frac[d] = valid ? pos - base : 0.0;
+        }
+        if (!valid)
+        { continue; }
+
+        if (dims == 1u)
+        {
+          local[idx[0]]      += 1.0 - frac[0];
+          local[idx[0] + 1u] += frac[0];
+        }
+        else
+        {
+          double* cell = local.data() + idx[0]*y_size + idx[1];
+          cell[0]           += (1.0 - frac[0])*(1.0 - frac[1]);
+          cell[1]           += (1.0 - frac[0])*frac[1];
+          cell[y_size]      += frac[0]*(1.0 - frac[1]);
+          cell[y_size + 1u] += frac[0]*frac[1];
+        }
+      }
+      std::lock_guard<std::mutex> lock(merge_lock);
+      for (std::size_t k = 0u; k < weights.size(); k++)
+      { weights[k] += local[k]; }
+    }, 1u << 16u);
+
+    // zero padding to 2*size makes the circular convolution linear over the grid
+    const std::size_t pad_x = next_pow2(2u*size);
+    const std::size_t pad_y = (dims == 1u) ? 1u : pad_x;
+    std::vector<std::complex<double>> signal(pad_x*pad_y), kernel(pad_x*pad_y);
+    for (std::size_t i = 0u; i < size; i++)
+    {
+      for (std::size_t j = 0u; j < y_size; j++)
+      { signal[i*pad_y + j] = weights[i*y_size + j]; }
+    }
+
+    // kernel sampled at every grid offset, negative offsets wrap around
+    const std::array<double, 4> inv{cov[3]/det, -cov[1]/det, -cov[2]/det, cov[0]/det};
+    const double pi   = 3.14159265358979323846;
+    const double norm = 1.0/(static_cast<double>(n_valid)*std::pow(2.0*pi, 0.5*static_cast<double>(dims))*std::sqrt(det));
+    auto offset = [](std::size_t k, std::size_t pad){ return (k < pad/2u) ? static_cast<double>(k) : static_cast<double>(k) - static_cast<double>(pad); };
+    for (std::size_t i = 0u; i < pad_x; i++)
+    {
+      const double dx = offset(i, pad_x)*step[0];
+      for (std::size_t j = 0u; j < pad_y; j++)
+      {
+        const double dy = (dims == 1u) ? 0.0 : offset(j, pad_y)*step[1];
+        const double quad = (dims == 1u) ? dx*dx/det : dx*(inv[0]*dx + inv[1]*dy) + dy*(inv[2]*dx + inv[3]*dy);
+        kernel[i*pad_y + j] = norm*std::exp(-0.5*quad);
+      }
+    }
+
+    fft2d(signal, pad_x, pad_y, false);
+    fft2d(kernel, pad_x, pad_y, false);
+    for (std::size_t k = 0u; k < signal.size(); k++)
+    { signal[k] *= kernel[k]; }
+    fft2d(signal, pad_x, pad_y, true);
+
+    // density is sent as (y, x) so that it can be passed to contour as is
+    const double scale = 1.0/static_cast<double>(signal.size());
+    for (std::size_t i = 0u; i < size; i++)
+    {
+      for (std::size_t j = 0u; j < y_size; j++)
+      { density[j*size + i] = std::max(signal[i*pad_y + j].real()*scale, 0.0); }
+    }
+  }
+
+  const std::size_t grid_bytes = size*sizeof(double);
+  buffer.rebuild(dims*grid_bytes + density.size()*sizeof(double));
+  char * ptr = static_cast<char*>(buffer.data());
+  for (std::size_t d = 0u; d < dims; d++)
+  { std::memcpy(ptr + d*grid_bytes, grids[d].data(), grid_bytes); }
+  std::memcpy(ptr + dims*grid_bytes, density.data(), density.size()*sizeof(double));
+}
+
+#endif
@@ -0,0 +1,256 @@
+#ifndef _CPPYPLOT_TRIGGER_H_
+#define _CPPYPLOT_TRIGGER_H_
+
+/*
+  * Oscilloscope style triggered capture for rare events.
+  * push() records every sample into a ring buffer of the last pre + post samples, nothing is sent in steady state.
+  * When the trigger fires (threshold crossing, predicate or an explicit trigger() call) the following 'post' samples
+  * are recorded and the window [trigger - pre, trigger + post) is copied once into one of 'max_pending' slots.
+  * Slots are handed over lock-free, a trigger firing while every slot waits to be sent is counted as missed.
+  * pyp.capture(_p(capture)) sends completed windows from the background sampler as soon as they are ready,
+  * _p(capture) in pyp.raw() sends the windows completed so far.
+  * Triggers are ignored until 'pre' samples are recorded and for 'holdoff' samples after every window.
+  * push() is for one producer thread, trigger() may be called from any thread, the trigger condition
+  * has to be set before pushing.
+  * payload: sample_rate (float64) | trigger sample index of every window (uint64) | windows (n x (pre + post) x width)
+*/
+enum class trigger_edge { rising, falling, both };
+
+template<typename T>
+struct capture_windows{
+  std::vector<std::uint64_t> triggers;
+  std::vector<T>             samples;
+};
+
+template<typename T>
+class triggered_capture{
+  static_assert(std::is_trivially_copyable_v<T> && is_scalar_v<typename watch_elem<T>::type>,
+                "captured samples have to be scalars or fixed size arrays of scalars");
+  public:
+    using value_type = typename watch_elem<T>::type;
+
+  private:
+    static constexpr std::uint64_t no_trigger = std::numeric_limits<std::uint64_t>::max();
+
+    std::size_t   pre_;
+    std::size_t   post_;
+    std::size_t   window_;
+    std::size_t   n_slots_;
+    double        sample_rate_;
+    std::uint64_t id_;
+
+    // producer side
+    std::vector<T>                ring_;
+    std::uint64_t                 mask_;
+    std::uint64_t                 head_       = 0u;          // samples pushed so far
+    std::uint64_t                 armed_at_   = 0u;          // first sample that may trigger
+    std::uint64_t                 trigger_at_ = no_trigger;  // trigger waiting for its post samples
+    double                        previous_   = std::numeric_limits<double>::quiet_NaN();
+    bool                          threshold_  = false;
+    double                        level_      = 0.0;
+    trigger_edge                  edge_       = trigger_edge::rising;
+    std::size_t                   channel_    = 0u;
+    std::size_t                   holdoff_    = 0u;
+    std::function<bool(const T&)> predicate_;
+    std::atomic<bool>             forced_{false};
+
+    // completed windows, written by push() and read by the sending thread
+    std::vector<T>                     slots_;
+    std::vector<std::uint64_t>         slot_triggers_;
+    std::atomic<std::uint64_t>         written_{0u};
+    mutable std::atomic<std::uint64_t> read_{0u};
+    std::atomic<std::uint64_t>         missed_{0u};
+    // windows taken for the message being sent, header and payload are created from the same windows
+    mutable std::shared_ptr<capture_windows<T>> taken_;
+
+    static std::uint64_t next_id() noexcept
+    {
+      static std::atomic<std::uint64_t> counter{0u};
+      return ++counter;
+    }
+
+    double channel_value(const T& sample) const noexcept
+    {
+      if constexpr (is_scalar_v<T>)
+      { return static_cast<double>(sample); }
+      else
+      { return static_cast<double>(sample[channel_]); }
+    }
+
+    bool fires(const T& sample, double value) noexcept
+    {
+      if (forced_.load(std::memory_order_relaxed) && forced_.exchange(false, std::memory_order_relaxed))
+      { return true; }
+      if (threshold_)
+      {
+        const bool rising  = (previous_ < level_) && (value >= level_);
+        const bool falling = (previous_ > level_) && (value <= level_);
+        if (   ((edge_ != trigger_edge::falling) && rising)
+            || ((edge_ != trigger_edge::rising)  && falling))
+        { return true; }
+      }
+      return predicate_ && predicate_(sample);
+    }
+
+    // copies the window of the pending trigger into a free slot
+    void complete() noexcept
+    {
+      const std::uint64_t written = written_.load(std::memory_order_relaxed);
+      if ((written - read_.load(std::memory_order_acquire)) < n_slots_)
+      {
+        const std::size_t slot  = static_cast<std::size_t>(written % n_slots_);
+        T * out                 = slots_.data() + slot*window_;
+        const std::uint64_t start = trigger_at_ - pre_;
+        const std::size_t first   = static_cast<std::size_t>(start & mask_);
+        const std::size_t n_first = std::min(window_, ring_.size() - first);
+        std::copy(ring_.begin() + static_cast<std::ptrdiff_t>(first), ring_.begin() + static_cast<std::ptrdiff_t>(first + n_first), out);
+        std::copy(ring_.begin(), ring_.begin() + static_cast<std::ptrdiff_t>(window_ - n_first), out + n_first);
+        slot_triggers_[slot] = trigger_at_;
+        written_.store(written + 1u, std::memory_order_release);
+      }
+      else
+      { missed_.fetch_add(1u, std::memory_order_relaxed); }
+
+      armed_at_   = head_ + holdoff_;
+      trigger_at_ = no_trigger;
+    }
+
+  public:
+    // post is at least one sample (the trigger sample), the ring holds the last pre + post samples
+    explicit triggered_capture(std::size_t pre, std::size_t post, std::size_t max_pending = 8u, double sample_rate = 1.0)
+      : pre_(pre), post_(std::max<std::size_t>(post, 1u)), window_(pre_ + post_),
+        n_slots_(std::max<std::size_t>(max_pending, 1u)), sample_rate_(sample_rate), id_(next_id()),
+        ring_(next_pow2(window_)), mask_(ring_.size() - 1u), armed_at_(pre_),
+        slots_(n_slots_*window_), slot_triggers_(n_slots_, 0u)
+    { }
+
+    triggered_capture(const triggered_capture&) = delete;
+    triggered_capture& operator=(const triggered_capture&) = delete;
+
+    // triggers when 'channel' (element of array samples) crosses 'level'
+    void on_threshold(double level, trigger_edge edge = trigger_edge::rising, std::size_t channel = 0u)
+    {
+      threshold_ = true;
+      level_     = level;
+      edge_      = edge;
+      channel_   = channel;
+    }
+
+    // triggers on every sample for which predicate(sample) is true
+    template<typename Predicate>
+    void on_predicate(Predicate&& predicate)
+    { predicate_ = std::forward<Predicate>(predicate); }
+
+    // samples after a completed window that cannot trigger
+    void set_holdoff(std::size_t n_samples) noexcept
+    { holdoff_ = n_samples; }
+
+    // the next pushed sample triggers (once armed), callable from any thread
+    void trigger() noexcept
+    { forced_.store(true, std::memory_order_relaxed); }
+
+    void push(const T& sample) noexcept
+    {
+      const std::uint64_t index = head_++;
+      ring_[static_cast<std::size_t>(index & mask_)] = sample;
+
+      const double value = channel_value(sample);
+      if ((trigger_at_ == no_trigger) && (index >= armed_at_) && fires(sample, value))
+      { trigger_at_ = index; }
+      previous_ = value;
+
+      if ((trigger_at_ != no_trigger) && (head_ == trigger_at_ + post_))
+      { complete(); }
+    }
+
+    void push(const T* samples, std::size_t n_samples) noexcept
+    {
+      for (std::size_t i = 0u; i < n_samples; i++)
+      { push(samples[i]); }
+    }
+
+    // windows completed and not sent yet
+    std::size_t pending() const noexcept
+    { return static_cast<std::size_t>(written_.load(std::memory_order_acquire) - read_.load(std::memory_order_relaxed)); }
+
+    // triggers dropped because every slot was waiting to be sent
+    std::uint64_t missed() const noexcept
+    { return missed_.load(std::memory_order_relaxed); }
+
+    // takes the completed windows (once per message), called by the sending thread
+    const capture_windows<T>& taken() const
+    {
+      if (taken_)
+      { return *taken_; }
+
+      auto windows = std::make_shared<capture_windows<T>>();
+      const std::uint64_t read    = read_.load(std::memory_order_relaxed);
+      const std::uint64_t written = written_.load(std::memory_order_acquire);
+      windows->triggers.reserve(static_cast<std::size_t>(written - read));
+      windows->samples.reserve(static_cast<std::size_t>(written - read)*window_);
+      for (std::uint64_t w = read; w < written; w++)
+      {
+        const std::size_t slot = static_cast<std::size_t>(w % n_slots_);
+        windows->triggers.push_back(slot_triggers_[slot]);
+        windows->samples.insert(windows->samples.end(), slots_.begin() + static_cast<std::ptrdiff_t>(slot*window_),
+                                slots_.begin() + static_cast<std::ptrdiff_t>((slot + 1u)*window_));
+      }
+      read_.store(written, std::memory_order_release);
+      taken_ = std::move(windows);
+      return *taken_;
+    }
+
+    // releases the windows taken for the last message
+    void release_taken() const noexcept
+    { taken_.reset(); }
+
+    std::size_t pre() const noexcept
+    { return pre_; }
+
+    std::size_t post() const noexcept
+    { return post_; }
+
+    std::size_t width() const noexcept
+    { return sizeof(T)/sizeof(value_type); }
+
+    double sample_rate() const noexcept
+    { return sample_rate_; }
+
+    std::uint64_t id() const noexcept
+    { return id_; }
+};
+
+template<typename T>
+inline std::size_t container_size(const triggered_capture<T>& data)
+{ return data.taken().samples.size()*data.width(); }
+
+template<typename T>
+inline std::array<std::size_t, 3> container_shape(const triggered_capture<T>& data)
+{ return std::array<std::size_t, 3>{data.taken().triggers.size(), data.pre() + data.post(), data.width()}; }
+
+template<typename T>
+inline std::string container_encoding(const triggered_capture<T>& data)
+{
+  return "capture:" + std::to_string(data.id()) + "," + std::to_string(data.pre()) + ","
+                    + std::to_string(data.post()) + "," + std::to_string(data.missed());
+}
+
+template<typename T>
+inline void fill_zmq_buffer(const triggered_capture<T>& data, zmq::message_t& buffer)
+{
+  const auto& windows      = data.taken();
+  const double sample_rate = data.sample_rate();
+  const std::size_t trigger_bytes = windows.triggers.size()*sizeof(std::uint64_t);
+  const std::size_t sample_bytes  = windows.samples.size()*sizeof(T);
+  buffer.rebuild(sizeof(sample_rate) + trigger_bytes + sample_bytes);
+  char * ptr = static_cast<char*>(buffer.data());
+  std::memcpy(ptr, &sample_rate, sizeof(sample_rate));
+  if (!windows.triggers.empty())
+  {
+    std::memcpy(ptr + sizeof(sample_rate), windows.triggers.data(), trigger_bytes);
+    std::memcpy(ptr + sizeof(sample_rate) + trigger_bytes, windows.samples.data(), sample_bytes);
+  }
+  data.release_taken();
+}
+
+#endif
@@ -7,14 +7,99 @@ struct ValType{
   const static char typestr{str};
 };
 
+/* numpy datetime64 ('M') and timedelta64 ('m') need the tick unit as well */
+template<typename T, char str, typename Period>
+struct TimeType{
+  const static std::size_t elem_size = sizeof(T);
+  const static char typestr{str};
+  using period = Period;
+};
+
+template<typename T>
+struct is_complex : std::false_type {};
+
+template<typename T>
+struct is_complex<std::complex<T>> : std::true_type {};
+
+template<typename T>
+struct is_duration : std::false_type {};
+
+template<typename Rep, typename Period>
+struct is_duration<std::chrono::duration<Rep, Period>> : std::true_type {};
+
+template<typename T>
+struct is_time_point : std::false_type {};
+
+template<typename Clock, typename Duration>
+struct is_time_point<std::chrono::time_point<Clock, Duration>> : std::true_type {};
+
+template<typename T>
+struct is_half : std::false_type {};
+
+#if defined(__FLT16_MAX__)
+template<>
+struct is_half<_Float16> : std::true_type {};
+#endif
+
+#if defined (EIGEN_AVAILABLE)
+template<>
+struct is_half<Eigen::half> : std::true_type {};
+#endif
+
+/* types that are sent as a single value (shape (0,)) */
+template<typename T>
+inline constexpr bool is_scalar_v =    std::is_arithmetic_v<T> || is_complex<T>::value || is_half<T>::value
+                                    || is_duration<T>::value   || is_time_point<T>::value;
+
+/* integers are described by their width so that int8_t, int64_t, long ... match on both sides */
+template<typename T>
+constexpr char integral_typestr()
+{
+  static_assert(sizeof(T) == 1u || sizeof(T) == 2u || sizeof(T) == 4u || sizeof(T) == 8u, 
+                "unsupported integer width");
+  constexpr bool is_signed = std::is_signed_v<T>;
+  if constexpr (sizeof(T) == 1u)
+  { return is_signed ? 'b' : 'B'; }
+  else if constexpr (sizeof(T) == 2u)
+  { return is_signed ? 'h' : 'H'; }
+  else if constexpr (sizeof(T) == 4u)
+  { return is_signed ? 'i' : 'I'; }
+  else
+  { return is_signed ? 'q' : 'Q'; }
+}
+
 template<typename T>
 constexpr auto unpack_type()
-{  return unpack_type<typename T::value_type>();  }
+{
+  if constexpr (is_duration<T>::value)
+  {
+    static_assert(std::is_integral_v<typename T::rep> && (sizeof(typename T::rep) == 8u), 
+                  "timedelta64 requires 64bit integer ticks");
+    return TimeType<T, 'm', typename T::period>{};
+  }
+  else if constexpr (is_time_point<T>::value)
+  {
+    using duration_t = typename T::duration;
+    static_assert(std::is_integral_v<typename duration_t::rep> && (sizeof(typename duration_t::rep) == 8u), 
+                  "datetime64 requires 64bit integer ticks");
+    // only system_clock shares the unix epoch, other clocks are sent as time since their epoch
+    if constexpr (std::is_same_v<typename T::clock, std::chrono::system_clock>)
+    { return TimeType<T, 'M', typename duration_t::period>{}; }
+    else
+    { return TimeType<T, 'm', typename duration_t::period>{}; }
+  }
+  else
+  {  return unpack_type<typename T::value_type>();  }
+}
 
 template<>
 constexpr auto unpack_type<char>()
 {  return ValType<char, 'c'>{};  }
 
+template<>
+constexpr auto unpack_type<bool>()
+{  return ValType<bool, '?'>{};  }
+
 template<>
 constexpr auto unpack_type<signed char>()
 {  return ValType<signed char, 'b'>{};  }
@@ -25,35 +110,35 @@ constexpr auto unpack_type<unsigned char>()
 
 template<>
 constexpr auto unpack_type<short> ()
-{  return ValType<short, 'h'>{};  }
+{  return ValType<short, integral_typestr<short>()>{};  }
 
 template<>
 constexpr auto unpack_type<unsigned short> ()
-{  return ValType<unsigned short, 'H'>{};  }
+{  return ValType<unsigned short, integral_typestr<unsigned short>()>{};  }
 
 template<>
 constexpr auto unpack_type<int> ()
-{  return ValType<int, 'i'>{};  }
+{  return ValType<int, integral_typestr<int>()>{};  }
 
 template<>
 constexpr auto unpack_type<unsigned int> ()
-{  return ValType<unsigned int, 'I'>{};  }
+{  return ValType<unsigned int, integral_typestr<unsigned int>()>{};  }
 
 template<>
 constexpr auto unpack_type<long> ()
-{  return ValType<long, 'l'>{};  }
+{  return ValType<long, integral_typestr<long>()>{};  }
 
 template<>
 constexpr auto unpack_type<unsigned long> ()
-{  return ValType<unsigned long, 'L'>{};  }
+{  return ValType<unsigned long, integral_typestr<unsigned long>()>{};  }
 
 template<>
 constexpr auto unpack_type<long long> ()
-{  return ValType<long long, 'q'>{};  }
+{  return ValType<long long, integral_typestr<long long>()>{};  }
 
 template<>
 constexpr auto unpack_type<unsigned long long> ()
-{  return ValType<unsigned long long, 'Q'>{};  }
+{  return ValType<unsigned long long, integral_typestr<unsigned long long>()>{};  }
 
 template<>
 constexpr auto unpack_type<float> ()
@@ -63,4 +148,47 @@ template<>
 constexpr auto unpack_type<double> ()
 {  return ValType<double, 'd'>{};  }
 
+template<>
+constexpr auto unpack_type<std::complex<float>> ()
+{  return ValType<std::complex<float>, 'F'>{};  }
+
+template<>
+constexpr auto unpack_type<std::complex<double>> ()
+{  return ValType<std::complex<double>, 'D'>{};  }
+
+#if defined(__FLT16_MAX__)
+template<>
+constexpr auto unpack_type<_Float16> ()
+{  return ValType<_Float16, 'e'>{};  }
+#endif
+
+#if defined (EIGEN_AVAILABLE)
+template<>
+constexpr auto unpack_type<Eigen::half> ()
+{  return ValType<Eigen::half, 'e'>{};  }
+#endif
+
+/* numpy dtype string of the element type, used in the data header */
+template<typename T, char str>
+inline std::string dtype_str(const ValType<T, str>& elem_type)
+{ (void)elem_type; return std::string{str}; }
+
+template<typename T, char str, typename Period>
+inline std::string dtype_str(const TimeType<T, str, Period>& elem_type)
+{
+  (void)elem_type;
+  std::string unit;
+  if constexpr      (std::is_same_v<Period, std::nano>)          { unit = "ns"; }
+  else if constexpr (std::is_same_v<Period, std::micro>)         { unit = "us"; }
+  else if constexpr (std::is_same_v<Period, std::milli>)         { unit = "ms"; }
+  else if constexpr (std::is_same_v<Period, std::ratio<1>>)      { unit = "s";  }
+  else if constexpr (std::is_same_v<Period, std::ratio<60>>)     { unit = "m";  }
+  else if constexpr (std::is_same_v<Period, std::ratio<3600>>)   { unit = "h";  }
+  else if constexpr (std::is_same_v<Period, std::ratio<86400>>)  { unit = "D";  }
+  else
+  { static_assert(!std::is_same_v<Period, Period>, "tick period has no numpy datetime unit"); }
+
+  return std::string{str} + "8[" + unit + "]";
+}
+
 #endif
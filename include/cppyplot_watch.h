@@ -0,0 +1,274 @@
+#ifndef _CPPYPLOT_WATCH_H_
+#define _CPPYPLOT_WATCH_H_
+
+/*
+  * Oscilloscope mode: variables (or getters) registered with pyp.watch(_p(x), rate_hz) are sampled by one background
+  * thread at their rate and streamed to python in batches (every WATCH_FLUSH_INTERVAL), the watched code is unchanged.
+  * Plain variables are copied until two consecutive copies agree, this retries multi-word writes in progress on another core
+  * but cannot see a writer that was preempted halfway. Values written through Cppyplot::seqlock<T> are always read
+  * consistently, the reader retries on the writer's sequence counter.
+  * Batches are only sent when no pyp.raw() call is sending, a busy socket delays the batch and not the sampling.
+  * Watched variables have to outlive the watch, call pyp.unwatch() before they go out of scope.
+  * Python side keeps the last 'history' samples of every watch in a Scope, show() draws it and follows new batches.
+  * payload: sample times (int64, ns since the sampler started) | samples (n x width)
+*/
+constexpr std::chrono::milliseconds WATCH_FLUSH_INTERVAL{33};
+
+/* socket lock, every message sequence (pyp.raw, watch batches) is sent while holding it */
+inline std::mutex& send_lock()
+{
+  static std::mutex lock;
+  return lock;
+}
+
+/*
+  * Single writer sequence lock, store() costs two atomic stores and the reader retries while a store is in progress.
+  * Cppyplot::seqlock<Pose> pose; ... pose = current_pose; ... pyp.watch(_p(pose), 100.0);
+*/
+template<typename T>
+class seqlock{
+  static_assert(std::is_trivially_copyable_v<T>, "seqlock values are copied bytewise");
+  private:
+    std::atomic<std::uint64_t> sequence_{0u};
+    T value_{};
+
+  public:
+    seqlock() = default;
+    explicit seqlock(const T& value) : value_(value) {}
+
+    void store(const T& value) noexcept
+    {
+      const std::uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+      sequence_.store(sequence + 1u, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      std::memcpy(&value_, &value, sizeof(T));
+      sequence_.store(sequence + 2u, std::memory_order_release);
+    }
+
+    seqlock& operator=(const T& value) noexcept
+    {
+      store(value);
+      return *this;
+    }
+
+    T load() const noexcept
+    {
+      T value;
+      std::uint64_t before = 0u, after = 0u;
+      do
+      {
+        before = sequence_.load(std::memory_order_acquire);
+        std::memcpy(&value, &value_, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = sequence_.load(std::memory_order_relaxed);
+      } while (((before & 1u) != 0u) || (before != after));
+      return value;
+    }
+};
+
+/* copies 'source' until two consecutive copies agree, the signal fence keeps the compiler from merging the copies */
+template<typename T>
+inline void read_consistent(const T& source, char* out)
+{
+  alignas(T) char previous[sizeof(T)];
+  std::memcpy(previous, &source, sizeof(T));
+  for (std::size_t attempt = 0u; attempt < 64u; attempt++)
+  {
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    std::memcpy(out, &source, sizeof(T));
+    if (std::memcmp(previous, out, sizeof(T)) == 0)
+    { return; }
+    std::memcpy(previous, out, sizeof(T));
+  }
+}
+
+/* element type of watched values, scalars or fixed size arrays of scalars (std::array<double, 3>, ...) */
+template<typename T, typename = void>
+struct watch_elem { using type = T; };
+
+template<typename T>
+struct watch_elem<T, std::enable_if_t<!is_scalar_v<T>>> { using type = typename T::value_type; };
+
+struct watch_entry{
+  std::string                           name;
+  std::uint64_t                         id           = 0u;
+  std::size_t                           width        = 1u;
+  std::size_t                           sample_bytes = 0u;
+  std::size_t                           history      = 0u;
+  std::chrono::nanoseconds              period{0};
+  std::chrono::steady_clock::time_point next_sample;
+  std::function<void(char*)>            sample;   // writes one sample
+  std::function<bool()>                 ready;    // entries without 'sample' (triggered captures) are sent when ready
+  std::function<void(watch_entry&)>     send;     // sends the pending samples, called with send_lock() held
+  std::vector<std::int64_t>             times;
+  std::vector<char>                     values;
+};
+
+/* pending samples of a watch, element type E */
+template<typename E>
+struct watch_batch{
+  using value_type = E;
+  const watch_entry& entry;
+};
+
+template<typename E>
+inline std::size_t container_size(const watch_batch<E>& data)
+{ return data.entry.times.size()*data.entry.width; }
+
+template<typename E>
+inline std::array<std::size_t, 2> container_shape(const watch_batch<E>& data)
+{ return std::array<std::size_t, 2>{data.entry.times.size(), data.entry.width}; }
+
+template<typename E>
+inline std::string container_encoding(const watch_batch<E>& data)
+{ return "watch:" + std::to_string(data.entry.id) + "," + std::to_string(data.entry.history); }
+
+template<typename E>
+inline void fill_zmq_buffer(const watch_batch<E>& data, zmq::message_t& buffer)
+{
+  const std::size_t time_bytes = data.entry.times.size()*sizeof(std::int64_t);
+  buffer.rebuild(time_bytes + data.entry.values.size());
+  if (time_bytes > 0u)
+  {
+    std::memcpy(buffer.data(), data.entry.times.data(), time_bytes);
+    std::memcpy(static_cast<char*>(buffer.data()) + time_bytes, data.entry.values.data(), data.entry.values.size());
+  }
+}
+
+/* background thread sampling every watch at its own rate */
+class watch_sampler{
+  private:
+    std::mutex                                lock_;   // guards entries_ and running_
+    std::condition_variable                   wake_;
+    std::vector<std::unique_ptr<watch_entry>> entries_;
+    std::thread                               thread_;
+    bool                                      running_ = false;
+    std::uint64_t                             next_id_ = 0u;
+    const std::chrono::steady_clock::time_point epoch_ = std::chrono::steady_clock::now();
+
+    void flush()
+    {
+      std::unique_lock<std::mutex> socket_lock(send_lock(), std::try_to_lock);
+      if (!socket_lock.owns_lock())
+      { return; }
+      for (auto& entry : entries_)
+      {
+        if (entry->sample ? entry->times.empty() : !entry->ready())
+        { continue; }
+        begin_message();
+        entry->send(*entry);
+        entry->times.clear();
+        entry->values.clear();
+      }
+    }
+
+    void run()
+    {
+      auto next_flush = std::chrono::steady_clock::now() + WATCH_FLUSH_INTERVAL;
+      std::unique_lock<std::mutex> lock(lock_);
+      while (running_)
+      {
+        if (entries_.empty())
+        {
+          wake_.wait(lock);
+          continue;
+        }
+
+        auto deadline = next_flush;
+        for (const auto& entry : entries_)
+        {
+          if (entry->sample)
+          { deadline = std::min(deadline, entry->next_sample); }
+        }
+        wake_.wait_until(lock, deadline);
+
+        const auto now = std::chrono::steady_clock::now();
+        for (auto& entry : entries_)
+        {
+          if (!entry->sample || (entry->next_sample > now))
+          { continue; }
+          const std::size_t offset = entry->values.size();
+          entry->values.resize(offset + entry->sample_bytes);
+          entry->sample(entry->values.data() + offset);
+          entry->times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(now - epoch_).count());
+
+          // samples missed while the thread was late are skipped, not sent in a burst
+          entry->next_sample += entry->period;
+          if (entry->next_sample <= now)
+          { entry->next_sample = now + entry->period; }
+
+          // only the last 'history' samples are kept while the socket is busy
+          if (entry->times.size() > 2u*entry->history)
+          {
+            const std::size_t n_drop = entry->times.size() - entry->history;
+            entry->times.erase(entry->times.begin(), entry->times.begin() + static_cast<std::ptrdiff_t>(n_drop));
+            entry->values.erase(entry->values.begin(), entry->values.begin() + static_cast<std::ptrdiff_t>(n_drop*entry->sample_bytes));
+          }
+        }
+
+        if (now >= next_flush)
+        {
+          flush();
+          // batches get larger and rarer while the server lags (adaptive fidelity)
+          next_flush = now + WATCH_FLUSH_INTERVAL*static_cast<int>(fidelity().decimation());
+        }
+      }
+    }
+
+  public:
+    watch_sampler() = default;
+    watch_sampler(const watch_sampler&) = delete;
+    watch_sampler& operator=(const watch_sampler&) = delete;
+    ~watch_sampler()
+    { stop(); }
+
+    // replaces a watch of the same name, an empty first batch creates the Scope (or Capture) on python side right away
+    void add(std::unique_ptr<watch_entry> entry)
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      entry->id = ++next_id_;
+      {
+        std::lock_guard<std::mutex> socket_lock(send_lock());
+        begin_message();
+        entry->send(*entry);
+      }
+      entry->next_sample = std::chrono::steady_clock::now();
+      entries_.erase(std::remove_if(entries_.begin(), entries_.end(), [&](const auto& other){ return other->name == entry->name; }),
+                     entries_.end());
+      entries_.push_back(std::move(entry));
+      if (!running_)
+      {
+        running_ = true;
+        thread_  = std::thread(&watch_sampler::run, this);
+      }
+      wake_.notify_one();
+    }
+
+    // pending samples are dropped, the server keeps what it received
+    void remove(const std::string& name)
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      entries_.erase(std::remove_if(entries_.begin(), entries_.end(), [&](const auto& entry){ return entry->name == name; }),
+                     entries_.end());
+    }
+
+    void stop()
+    {
+      {
+        std::lock_guard<std::mutex> lock(lock_);
+        entries_.clear();
+        running_ = false;
+      }
+      wake_.notify_one();
+      if (thread_.joinable())
+      { thread_.join(); }
+    }
+};
+
+inline watch_sampler& watches()
+{
+  static watch_sampler sampler;
+  return sampler;
+}
+
+#endif